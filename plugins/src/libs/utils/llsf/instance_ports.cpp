@@ -0,0 +1,71 @@
+/***************************************************************************
+ *  instance_ports.cpp - Ports of a simulation instance
+ *
+ *  Created:   Sun 18 Oct 16:12:50 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <utils/llsf/instance_ports.h>
+#include <utils/llsf/machine_registry.h>
+
+#include <cstdlib>
+
+namespace llsf_utils {
+
+/** Get the number of this simulation instance.
+ * Several simulations can run side by side on one host if each of them uses
+ * a different instance number, set with the environment variable
+ * GAZEBO_RCLL_INSTANCE.
+ * @return the instance number, 0 if not set or invalid
+ */
+unsigned int
+instance_number()
+{
+	const char *instance = getenv(GAZEBO_RCLL_INSTANCE_ENV);
+	if (!instance) {
+		return 0;
+	}
+	char *        end;
+	unsigned long number = strtoul(instance, &end, 10);
+	if (end == instance || *end != '\0') {
+		return 0;
+	}
+	return number;
+}
+
+/** Get a port shifted for this simulation instance.
+ * @param base_port the port used by instance 0
+ * @param stride the distance between the ports of two instances
+ * @return the port to use in this instance
+ */
+unsigned int
+instance_port(unsigned int base_port, unsigned int stride)
+{
+	return base_port + instance_number() * stride;
+}
+
+/** Get the offset of a station's OPC UA port from the port base.
+ * Cyan stations use the offsets 0 to 6, magenta stations 10 to 16.
+ * @param station_name the name of the station, e.g. C-BS
+ * @return the offset of the port, -1 for an unknown station
+ */
+int
+station_port_offset(const std::string &station_name)
+{
+	MachineId id = machine_id(station_name);
+	return id == INVALID_MACHINE ? -1 : machine_info(id).port_offset;
+}
+
+} // namespace llsf_utils
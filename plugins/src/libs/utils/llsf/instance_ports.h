@@ -0,0 +1,39 @@
+/***************************************************************************
+ *  instance_ports.h - Ports of a simulation instance
+ *
+ *  Created:   Sun 18 Oct 16:12:50 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#ifndef __UTILS_LLSF_INSTANCE_PORTS_H_
+#define __UTILS_LLSF_INSTANCE_PORTS_H_
+
+#include <string>
+
+namespace llsf_utils {
+
+/// Environment variable selecting the simulation instance
+#define GAZEBO_RCLL_INSTANCE_ENV "GAZEBO_RCLL_INSTANCE"
+
+/// Offset of the port of the OPC UA server shared by all stations
+constexpr unsigned int SHARED_PORT_OFFSET = 20;
+
+extern unsigned int instance_number();
+extern unsigned int instance_port(unsigned int base_port, unsigned int stride);
+extern int          station_port_offset(const std::string &station_name);
+
+} // namespace llsf_utils
+
+#endif
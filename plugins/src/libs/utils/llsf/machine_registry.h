@@ -0,0 +1,157 @@
+/***************************************************************************
+ *  machine_registry.h - Compile-time table of the RCLL machines
+ *
+ *  Created:   Sun 18 Oct 19:02:17 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#ifndef __UTILS_LLSF_MACHINE_REGISTRY_H_
+#define __UTILS_LLSF_MACHINE_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace llsf_utils {
+
+/// Type of a machine
+enum class MachineType : uint8_t { BS, CS, RS, DS, SS };
+
+/// Team a machine belongs to
+enum class MachineTeam : uint8_t { CYAN, MAGENTA };
+
+/// Compact machine ID, the index into the machine table
+typedef uint8_t MachineId;
+
+/// ID returned for names which are not a machine
+constexpr MachineId INVALID_MACHINE = 0xff;
+
+/// Number of machines of each team
+constexpr std::size_t MACHINES_PER_TEAM = 7;
+
+/// Number of machines
+constexpr std::size_t MACHINE_COUNT = 2 * MACHINES_PER_TEAM;
+
+/** Static information about one machine. */
+struct MachineInfo
+{
+	/// name of the machine, e.g. C-CS1
+	const char *name;
+	MachineType type;
+	MachineTeam team;
+	/// OPC UA station code, the action ids of the station start there
+	uint16_t station_code;
+	/// ID of the tag mounted at the input
+	uint16_t input_tag;
+	/// ID of the tag mounted at the output
+	uint16_t output_tag;
+	/// offset of the OPC UA port from the port base
+	uint16_t port_offset;
+	/// name of the gazebo model of the machine
+	const char *model;
+};
+
+/// All machines, indexed by MachineId: cyan BS, CS1, CS2, RS1, RS2, DS, SS, then magenta
+constexpr MachineInfo machines[MACHINE_COUNT] = {
+  {"C-BS", MachineType::BS, MachineTeam::CYAN, 100, 65, 66, 0, "mps_base"},
+  {"C-CS1", MachineType::CS, MachineTeam::CYAN, 300, 1, 2, 1, "mps_cap"},
+  {"C-CS2", MachineType::CS, MachineTeam::CYAN, 300, 17, 18, 2, "mps_cap"},
+  {"C-RS1", MachineType::RS, MachineTeam::CYAN, 200, 33, 34, 3, "mps_ring"},
+  {"C-RS2", MachineType::RS, MachineTeam::CYAN, 200, 177, 178, 4, "mps_ring"},
+  {"C-DS", MachineType::DS, MachineTeam::CYAN, 400, 81, 82, 5, "mps_delivery"},
+  {"C-SS", MachineType::SS, MachineTeam::CYAN, 500, 193, 194, 6, "mps_storage"},
+  {"M-BS", MachineType::BS, MachineTeam::MAGENTA, 100, 161, 162, 10, "mps_base"},
+  {"M-CS1", MachineType::CS, MachineTeam::MAGENTA, 300, 97, 98, 11, "mps_cap"},
+  {"M-CS2", MachineType::CS, MachineTeam::MAGENTA, 300, 113, 114, 12, "mps_cap"},
+  {"M-RS1", MachineType::RS, MachineTeam::MAGENTA, 200, 129, 130, 13, "mps_ring"},
+  {"M-RS2", MachineType::RS, MachineTeam::MAGENTA, 200, 145, 146, 14, "mps_ring"},
+  {"M-DS", MachineType::DS, MachineTeam::MAGENTA, 400, 49, 50, 15, "mps_delivery"},
+  {"M-SS", MachineType::SS, MachineTeam::MAGENTA, 500, 209, 210, 16, "mps_storage"},
+};
+
+/** Get the ID of a machine.
+ * The ID is computed from the structure of the name (team, type and number),
+ * so this is a perfect hash which only needs a single string comparison to
+ * reject names which are not a machine.
+ * @param name the name of the machine, e.g. C-CS1
+ * @return the ID of the machine, INVALID_MACHINE if there is no such machine
+ */
+constexpr MachineId
+machine_id(std::string_view name)
+{
+	if (name.size() < 4 || name[1] != '-') {
+		return INVALID_MACHINE;
+	}
+	std::size_t team = 0;
+	switch (name[0]) {
+	case 'C': team = 0; break;
+	case 'M': team = 1; break;
+	default: return INVALID_MACHINE;
+	}
+	const char  number = name.size() > 4 ? name[4] : '1';
+	std::size_t slot   = 0;
+	switch (name[2]) {
+	case 'B': slot = 0; break;
+	case 'C': slot = number == '2' ? 2 : 1; break;
+	case 'R': slot = number == '2' ? 4 : 3; break;
+	case 'D': slot = 5; break;
+	case 'S': slot = 6; break;
+	default: return INVALID_MACHINE;
+	}
+	const std::size_t id = team * MACHINES_PER_TEAM + slot;
+	return name == machines[id].name ? MachineId(id) : INVALID_MACHINE;
+}
+
+/** Check whether a name is the name of a machine.
+ * @param name the name to check
+ * @return true if name is a machine, e.g. C-BS
+ */
+constexpr bool
+is_machine(std::string_view name)
+{
+	return machine_id(name) != INVALID_MACHINE;
+}
+
+/** Get the information about a machine.
+ * @param id the ID of the machine, must be valid
+ * @return the entry of the machine in the machine table
+ */
+constexpr const MachineInfo &
+machine_info(MachineId id)
+{
+	return machines[id];
+}
+
+/** Get the name of the model of a tag.
+ * @param tag the ID of the tag
+ * @return the name of the tag's model, e.g. tag_01
+ */
+inline std::string
+tag_model_name(uint16_t tag)
+{
+	return (tag < 10 ? "tag_0" : "tag_") + std::to_string(tag);
+}
+
+static_assert(machine_id("C-BS") == 0, "machine table out of order");
+static_assert(machine_id("C-SS") == 6, "machine table out of order");
+static_assert(machine_id("M-CS2") == 9, "machine table out of order");
+static_assert(machine_id("M-SS") == 13, "machine table out of order");
+static_assert(machine_id("C-CS3") == INVALID_MACHINE, "unknown machine accepted");
+static_assert(machine_id("tag_01") == INVALID_MACHINE, "unknown machine accepted");
+
+} // namespace llsf_utils
+
+#endif
@@ -24,6 +24,8 @@
 #	define GZWRAP_BASE_BY_NAME BaseByName
 #	define GZWRAP_RELATIVE_LINEAR_VEL RelativeLinearVel
 #	define GZWRAP_RELATIVE_ANGULAR_VEL RelativeAngularVel
+#	define GZWRAP_WORLD_LINEAR_VEL WorldLinearVel
+#	define GZWRAP_WORLD_ANGULAR_VEL WorldAngularVel
 
 #	define GZWRAP_POS Pos()
 #	define GZWRAP_ROT Rot()
@@ -64,6 +66,8 @@
 #	define GZWRAP_BASE_BY_NAME GetByName
 #	define GZWRAP_RELATIVE_LINEAR_VEL GetRelativeLinearVel
 #	define GZWRAP_RELATIVE_ANGULAR_VEL GetRelativeAngularVel
+#	define GZWRAP_WORLD_LINEAR_VEL GetWorldLinearVel
+#	define GZWRAP_WORLD_ANGULAR_VEL GetWorldAngularVel
 
 #	define GZWRAP_POS pos
 #	define GZWRAP_ROT rot
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *  publication_policy.cpp - When to publish a slowly changing value
+ *
+ *  Created:   Sun 18 Oct 23:58:20 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <utils/misc/publication_policy.h>
+
+#include <cmath>
+
+namespace gazebo_rcll {
+
+/** Constructor.
+ * @param max_rate max number of publications per second
+ * @param min_rate min number of publications per second, 0 to only publish
+ * changes
+ * @param position_epsilon min change of a position to publish it
+ * @param angle_epsilon min change of an angle in radians to publish it
+ */
+PublicationPolicy::PublicationPolicy(double max_rate,
+                                     double min_rate,
+                                     double position_epsilon,
+                                     double angle_epsilon)
+: min_interval_(1.0 / max_rate),
+  max_interval_(min_rate > 0 ? 1.0 / min_rate : INFINITY),
+  position_epsilon_(position_epsilon),
+  angle_epsilon_(angle_epsilon)
+{
+}
+
+/** Check if the max rate allows to publish.
+ * This is cheap, use it before reading the value to publish.
+ * @param state the publication state of the value
+ * @param time the current simulation time
+ * @return true if the value may be published
+ */
+bool
+PublicationPolicy::due(const PublicationState &state, double time) const
+{
+	return state.last_time < 0 || time - state.last_time >= min_interval_;
+}
+
+/** Check if the value must be published even if it did not change.
+ * @param state the publication state of the value
+ * @param time the current simulation time
+ * @return true if the heartbeat is due
+ */
+bool
+PublicationPolicy::heartbeat_due(const PublicationState &state, double time) const
+{
+	return state.last_time < 0 || time - state.last_time >= max_interval_;
+}
+
+/** Decide whether to publish a value.
+ * If so, the value is recorded as published in the state.
+ * @param state the publication state of the value
+ * @param time the current simulation time
+ * @param positions the positions of the value
+ * @param angles the angles of the value in radians
+ * @return true if the value should be published now
+ */
+bool
+PublicationPolicy::check(PublicationState &            state,
+                         double                        time,
+                         std::initializer_list<double> positions,
+                         std::initializer_list<double> angles) const
+{
+	if (!due(state, time)) {
+		return false;
+	}
+	bool publish =
+	  heartbeat_due(state, time) || state.values.size() != positions.size() + angles.size();
+	if (!publish) {
+		auto last = state.values.begin();
+		for (double position : positions) {
+			publish = publish || std::fabs(position - *last++) >= position_epsilon_;
+		}
+		for (double angle : angles) {
+			// the shortest distance, angles may wrap around
+			double diff = std::remainder(angle - *last++, 2 * M_PI);
+			publish     = publish || std::fabs(diff) >= angle_epsilon_;
+		}
+	}
+	if (publish) {
+		state.last_time = time;
+		state.values.assign(positions);
+		state.values.insert(state.values.end(), angles);
+	}
+	return publish;
+}
+
+} // namespace gazebo_rcll
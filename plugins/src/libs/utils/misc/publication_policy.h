@@ -0,0 +1,76 @@
+/***************************************************************************
+ *  publication_policy.h - When to publish a slowly changing value
+ *
+ *  Created:   Sun 18 Oct 23:58:20 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#ifndef __UTILS_MISC_PUBLICATION_POLICY_H_
+#define __UTILS_MISC_PUBLICATION_POLICY_H_
+
+#include <initializer_list>
+#include <vector>
+
+namespace gazebo_rcll {
+
+/** Publication state of one value stream, e.g. the pose of one model. */
+struct PublicationState
+{
+	/// simulation time of the last publication, negative if never published
+	double last_time = -1;
+	/// the positions and angles of the last publication
+	std::vector<double> values;
+};
+
+/** Policy to only publish a value when it changed meaningfully.
+ * A value is published at most with the max rate. It is published if any of
+ * its positions or angles changed by at least the respective epsilon since
+ * it was last published, and at least with the min rate as a heartbeat, so
+ * consumers still get a periodic refresh of values which do not change.
+ */
+class PublicationPolicy
+{
+public:
+	PublicationPolicy(double max_rate,
+	                  double min_rate,
+	                  double position_epsilon,
+	                  double angle_epsilon);
+
+	bool due(const PublicationState &state, double time) const;
+	bool heartbeat_due(const PublicationState &state, double time) const;
+	bool check(PublicationState &            state,
+	           double                        time,
+	           std::initializer_list<double> positions,
+	           std::initializer_list<double> angles) const;
+
+	/** Get the minimum time between two publications.
+	 * @return the inverse of the max rate in seconds
+	 */
+	double
+	min_interval() const
+	{
+		return min_interval_;
+	}
+
+private:
+	double min_interval_;
+	double max_interval_;
+	double position_epsilon_;
+	double angle_epsilon_;
+};
+
+} // namespace gazebo_rcll
+
+#endif
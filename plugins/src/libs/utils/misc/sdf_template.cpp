@@ -0,0 +1,164 @@
+/***************************************************************************
+ *  sdf_template.cpp - Cached model SDFs with substitution slots
+ *
+ *  Created:   Sun 18 Oct 21:41:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <utils/misc/sdf_template.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+namespace gazebo_rcll {
+
+/** Create an empty template. */
+SdfTemplate::SdfTemplate() : literal_size_(0)
+{
+}
+
+/** Split a text at its substitution points.
+ * @param text the text, e.g. the content of a model SDF
+ * @param substitutions the texts to replace, the index of a substitution is
+ * the slot its value is taken from
+ */
+SdfTemplate::SdfTemplate(const std::string &text, const std::vector<Substitution> &substitutions)
+: literal_size_(0)
+{
+	std::vector<bool> replaced(substitutions.size(), false);
+	std::size_t       pos = 0;
+	while (true) {
+		std::size_t match = std::string::npos;
+		std::size_t slot  = NO_SLOT;
+		for (std::size_t i = 0; i < substitutions.size(); i++) {
+			if (substitutions[i].pattern.empty() || (replaced[i] && !substitutions[i].all)) {
+				continue;
+			}
+			std::size_t found = text.find(substitutions[i].pattern, pos);
+			if (found < match) {
+				match = found;
+				slot  = i;
+			}
+		}
+		if (match == std::string::npos) {
+			break;
+		}
+		append(text.substr(pos, match - pos));
+		parts_.push_back(Part{std::string(), slot});
+		replaced[slot] = true;
+		pos            = match + substitutions[slot].pattern.size();
+	}
+	append(text.substr(pos));
+}
+
+void
+SdfTemplate::append(const std::string &text)
+{
+	if (text.empty()) {
+		return;
+	}
+	if (!parts_.empty() && parts_.back().slot == NO_SLOT) {
+		parts_.back().text += text;
+	} else {
+		parts_.push_back(Part{text, NO_SLOT});
+	}
+	literal_size_ += text.size();
+}
+
+/** Check whether the text of a substitution was found.
+ * @param slot the slot of the substitution
+ * @return true if the template has at least one substitution point for slot
+ */
+bool
+SdfTemplate::has_slot(std::size_t slot) const
+{
+	for (const Part &part : parts_) {
+		if (part.slot == slot) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Fill in a slot with a fixed value.
+ * Use this to precompile variants of a template, e.g. one per color.
+ * @param slot the slot to fill in
+ * @param value the value of the slot
+ * @return a template with the slot replaced by value
+ */
+SdfTemplate
+SdfTemplate::bind(std::size_t slot, const std::string &value) const
+{
+	SdfTemplate bound;
+	for (const Part &part : parts_) {
+		if (part.slot == NO_SLOT) {
+			bound.append(part.text);
+		} else if (part.slot == slot) {
+			bound.append(value);
+		} else {
+			bound.parts_.push_back(part);
+		}
+	}
+	return bound;
+}
+
+/** Render the template in a single pass.
+ * @param values the values of the slots which are not bound
+ * @param out the buffer to render to, its capacity is reused between calls
+ */
+void
+SdfTemplate::render(const std::vector<std::string> &values, std::string &out) const
+{
+	out.clear();
+	out.reserve(literal_size_);
+	for (const Part &part : parts_) {
+		out.append(part.slot == NO_SLOT ? part.text : values.at(part.slot));
+	}
+}
+
+/** Get the SDF of a model of this repository.
+ * The file $GAZEBO_RCLL/models/<model>/model.sdf is only read on first use.
+ * @param model the name of the model, e.g. workpiece_base
+ * @return the content of the model SDF, nullptr if it cannot be read
+ */
+std::shared_ptr<const std::string>
+model_sdf(const std::string &model)
+{
+	static std::mutex                                                cache_mutex;
+	static std::map<std::string, std::shared_ptr<const std::string>> cache;
+
+	std::lock_guard<std::mutex> lock{cache_mutex};
+	auto                        cached = cache.find(model);
+	if (cached != cache.end()) {
+		return cached->second;
+	}
+	const char *base_path = getenv("GAZEBO_RCLL");
+	if (!base_path) {
+		return nullptr;
+	}
+	std::ifstream file(std::string(base_path) + "/models/" + model + "/model.sdf");
+	if (!file.is_open()) {
+		return nullptr;
+	}
+	auto sdf = std::make_shared<const std::string>(std::istreambuf_iterator<char>(file),
+	                                               std::istreambuf_iterator<char>());
+	cache[model] = sdf;
+	return sdf;
+}
+
+} // namespace gazebo_rcll
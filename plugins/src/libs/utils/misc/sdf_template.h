@@ -0,0 +1,72 @@
+/***************************************************************************
+ *  sdf_template.h - Cached model SDFs with substitution slots
+ *
+ *  Created:   Sun 18 Oct 21:41:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#ifndef __UTILS_MISC_SDF_TEMPLATE_H_
+#define __UTILS_MISC_SDF_TEMPLATE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gazebo_rcll {
+
+/** A text split into literal parts and substitution slots.
+ * The text is scanned once for the substitution points, rendering only
+ * concatenates the parts and the slot values.
+ */
+class SdfTemplate
+{
+public:
+	/** A text to replace by the value of a slot. */
+	struct Substitution
+	{
+		/// the text to replace
+		std::string pattern;
+		/// replace every occurrence instead of only the first one
+		bool all;
+	};
+
+	SdfTemplate();
+	SdfTemplate(const std::string &text, const std::vector<Substitution> &substitutions);
+
+	bool        has_slot(std::size_t slot) const;
+	SdfTemplate bind(std::size_t slot, const std::string &value) const;
+	void        render(const std::vector<std::string> &values, std::string &out) const;
+
+private:
+	struct Part
+	{
+		std::string text;
+		/// the slot, or NO_SLOT for a literal part
+		std::size_t slot;
+	};
+	static constexpr std::size_t NO_SLOT = std::size_t(-1);
+
+	void append(const std::string &text);
+
+	std::vector<Part> parts_;
+	std::size_t       literal_size_;
+};
+
+extern std::shared_ptr<const std::string> model_sdf(const std::string &model);
+
+} // namespace gazebo_rcll
+
+#endif
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *  workpiece_journal.cpp - Binary journal of the workpiece lifecycle
+ *
+ *  Created:   Sun 18 Oct 23:02:47 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <utils/llsf/instance_ports.h>
+#include <utils/misc/workpiece_journal.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace gazebo_rcll {
+
+/** Open the journal of this simulation instance.
+ * All callers of the same process share one journal per file. The file is
+ * truncated when it is opened first. In instances other than 0, the
+ * instance number is appended to the file name.
+ * @param file the file to write to, empty to disable the journal
+ * @param capacity the maximum number of records
+ * @return the journal, nullptr if disabled or if the file cannot be mapped
+ */
+std::shared_ptr<WorkpieceJournal>
+WorkpieceJournal::open(const std::string &file, uint64_t capacity)
+{
+	static std::mutex                                              journals_mutex;
+	static std::map<std::string, std::weak_ptr<WorkpieceJournal>> journals;
+
+	if (file.empty() || capacity == 0) {
+		return nullptr;
+	}
+	std::string path = file;
+	if (llsf_utils::instance_number() > 0) {
+		path += "." + std::to_string(llsf_utils::instance_number());
+	}
+
+	std::lock_guard<std::mutex>       lock{journals_mutex};
+	std::shared_ptr<WorkpieceJournal> journal = journals[path].lock();
+	if (journal) {
+		return journal;
+	}
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		perror(("Cannot open workpiece journal " + path).c_str());
+		return nullptr;
+	}
+	// the file is sparse, only the pages of written records take up space
+	std::size_t size = sizeof(JournalHeader) + capacity * sizeof(JournalRecord);
+	if (ftruncate(fd, size) != 0) {
+		perror(("Cannot resize workpiece journal " + path).c_str());
+		::close(fd);
+		return nullptr;
+	}
+	void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED) {
+		perror(("Cannot map workpiece journal " + path).c_str());
+		::close(fd);
+		return nullptr;
+	}
+	JournalHeader *header = new (mapping) JournalHeader;
+	memcpy(header->magic, MAGIC, sizeof(header->magic));
+	header->version     = VERSION;
+	header->record_size = sizeof(JournalRecord);
+	header->capacity    = capacity;
+	header->next.store(0);
+	header->dropped.store(0);
+
+	journal        = std::shared_ptr<WorkpieceJournal>(new WorkpieceJournal(fd, mapping, size));
+	journals[path] = journal;
+	return journal;
+}
+
+WorkpieceJournal::WorkpieceJournal(int fd, void *mapping, std::size_t size)
+: fd_(fd), mapping_(mapping), size_(size)
+{
+	header_  = static_cast<JournalHeader *>(mapping_);
+	records_ = reinterpret_cast<JournalRecord *>(header_ + 1);
+}
+
+WorkpieceJournal::~WorkpieceJournal()
+{
+	msync(mapping_, size_, MS_SYNC);
+	munmap(mapping_, size_);
+	::close(fd_);
+}
+
+/** Append an event.
+ * This never blocks, it may be called from any thread.
+ * @param event the event
+ * @param sim_time the simulation time of the event
+ * @param workpiece the name of the workpiece
+ * @param subject the station or gripper involved in the event
+ * @param value the color, zone or team, depending on the event
+ */
+void
+WorkpieceJournal::record(JournalEvent       event,
+                         double             sim_time,
+                         const std::string &workpiece,
+                         const std::string &subject,
+                         uint16_t           value)
+{
+	uint64_t slot = header_->next.fetch_add(1, std::memory_order_relaxed);
+	if (slot >= header_->capacity) {
+		header_->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	JournalRecord &record = records_[slot];
+	record.sim_time       = sim_time;
+	record.value          = value;
+	strncpy(record.workpiece, workpiece.c_str(), JOURNAL_NAME_SIZE - 1);
+	strncpy(record.subject, subject.c_str(), JOURNAL_NAME_SIZE - 1);
+	record.event.store(uint16_t(event), std::memory_order_release);
+}
+
+} // namespace gazebo_rcll
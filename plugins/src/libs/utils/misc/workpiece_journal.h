@@ -0,0 +1,126 @@
+/***************************************************************************
+ *  workpiece_journal.h - Binary journal of the workpiece lifecycle
+ *
+ *  Created:   Sun 18 Oct 23:02:47 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#ifndef __UTILS_MISC_WORKPIECE_JOURNAL_H_
+#define __UTILS_MISC_WORKPIECE_JOURNAL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gazebo_rcll {
+
+/// Events of the workpiece lifecycle
+enum class JournalEvent : uint16_t {
+	/// the record is not written completely
+	NONE = 0,
+	/// a station put a new workpiece into the game, value is the base color
+	SPAWN,
+	/// the workpiece entered a zone of a station, value is the zone
+	ZONE_ENTER,
+	/// the workpiece left a zone of a station, value is the zone
+	ZONE_LEAVE,
+	/// a ring was mounted, value is the ring color
+	RING,
+	/// a cap was mounted, value is the cap color
+	CAP,
+	/// the cap was removed, value is the cap color
+	CAP_REMOVED,
+	/// a gripper took the workpiece
+	GRIP,
+	/// a gripper released the workpiece
+	RELEASE,
+	/// the workpiece was delivered, value is the team
+	DELIVER,
+	/// the workpiece was taken out of the game for reuse
+	RECYCLE,
+};
+
+/// Size of the name fields of a record, including the terminating zero
+constexpr std::size_t JOURNAL_NAME_SIZE = 24;
+
+/** A fixed size record of the journal. */
+struct JournalRecord
+{
+	double sim_time;
+	/// a JournalEvent, written last, so a reader never sees half a record
+	std::atomic<uint16_t> event;
+	uint16_t              value;
+	uint32_t              reserved;
+	/// the workpiece, possibly truncated
+	char workpiece[JOURNAL_NAME_SIZE];
+	/// the station or gripper involved, possibly truncated
+	char subject[JOURNAL_NAME_SIZE];
+};
+
+/** Header at the start of a journal file. */
+struct JournalHeader
+{
+	char     magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t capacity;
+	/// number of claimed records, may exceed the capacity
+	std::atomic<uint64_t> next;
+	/// number of records dropped because the journal was full
+	std::atomic<uint64_t> dropped;
+	char                  padding[24];
+};
+
+/** Append-only journal of workpiece lifecycle events.
+ * The journal is a memory mapped file of fixed size records. Writers claim a
+ * record with an atomic increment and fill it in place, so events can be
+ * written from any thread without locks. Once the file is full, further
+ * events are counted but dropped.
+ */
+class WorkpieceJournal
+{
+public:
+	static constexpr const char *MAGIC   = "GZWPJRNL";
+	static constexpr uint32_t    VERSION = 1;
+
+	static std::shared_ptr<WorkpieceJournal> open(const std::string &file, uint64_t capacity);
+	~WorkpieceJournal();
+
+	void record(JournalEvent       event,
+	            double             sim_time,
+	            const std::string &workpiece,
+	            const std::string &subject = "",
+	            uint16_t           value   = 0);
+
+private:
+	WorkpieceJournal(int fd, void *mapping, std::size_t size);
+
+	int            fd_;
+	void *         mapping_;
+	std::size_t    size_;
+	JournalHeader *header_;
+	JournalRecord *records_;
+};
+
+static_assert(sizeof(JournalRecord) == 64, "journal records must keep their size");
+static_assert(sizeof(JournalHeader) == 64, "the journal header must keep its size");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "journal counters must be lock-free");
+static_assert(std::atomic<uint16_t>::is_always_lock_free, "journal events must be lock-free");
+
+} // namespace gazebo_rcll
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "../mps/mps.h"
 
+#include <utils/llsf/machine_registry.h>
 #include <utils/misc/gazebo_api_wrappers.h>
 
 #include <math.h>
@@ -87,6 +88,7 @@ ConveyorVision::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 
 	//init last sent time
 	last_sent_time_      = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+	frame_registry_      = StationFrameRegistry::instance(model_->GetWorld());
 	this->send_interval_ = 0.05;
 }
 
@@ -116,15 +118,6 @@ ConveyorVision::on_set_conveyor_msg(ConstIntPtr &msg)
 	offset_z_ += ((float)msg->data()) / 1000.;
 }
 
-inline bool
-is_machine(gazebo::physics::ModelPtr model)
-{
-	std::string name = model->GetName();
-	return ((name.find("BS") != std::string::npos) || (name.find("SS") != std::string::npos)
-	        || (name.find("CS") != std::string::npos) || (name.find("DS") != std::string::npos)
-	        || (name.find("RS") != std::string::npos));
-}
-
 void
 ConveyorVision::send_conveyor_result()
 {
@@ -156,73 +149,28 @@ ConveyorVision::send_conveyor_result()
 #endif
 	for (gazebo::physics::Model_V::iterator it = models.begin(); it != models.end(); it++) {
 		gazebo::physics::ModelPtr model = *it;
-		if (is_machine(model)
+		llsf_utils::MachineId machine = llsf_utils::machine_id(model->GetName());
+		if (machine != llsf_utils::INVALID_MACHINE
 		    && look_pose.GZWRAP_POS.Distance(model->GZWRAP_WORLD_POSE().GZWRAP_POS
 		                                     + gzwrap::Vector3d(0, 0, BELT_HEIGHT))
 		         < RADIUS_DETECTION_AREA) {
 			//check which side of the conveyor the bot is looking on
-			gzwrap::Pose3d            mps_pose = model->GZWRAP_WORLD_POSE();
-			const gzwrap::Quaterniond yaw_correction(0, 0, IGN_PI_2);
-			//Calculate conveyor input position (positive X points twards conveyor mid-point)
-			//        z up
-			//       /
-			//      x---> I=====O
-			//      |
-			//      y
-			double conv_input_x = mps_pose.GZWRAP_POS_X + BELT_OFFSET_SIDE * cos(mps_pose.GZWRAP_ROT_YAW)
-			                      - (BELT_LENGTH / 2 - PUCK_SIZE) * sin(mps_pose.GZWRAP_ROT_YAW);
-			double conv_input_y = mps_pose.GZWRAP_POS_Y + BELT_OFFSET_SIDE * sin(mps_pose.GZWRAP_ROT_YAW)
-			                      + (BELT_LENGTH / 2 - PUCK_SIZE) * cos(mps_pose.GZWRAP_ROT_YAW);
-			const gzwrap::Vector3d conv_input_pose(conv_input_x, conv_input_y, BELT_HEIGHT);
-
-			const gzwrap::Quaterniond conv_input_angle = mps_pose.GZWRAP_ROT_SUB(yaw_correction);
-
-			gzwrap::Pose3d input_pose(conv_input_pose, conv_input_angle);
-
-			//Calculate output conveyor position (positive X points twards conveyor mid-point)
-			//                    z up
-			//                   /
-			//    I=====O  <--- x
-			//                  |
-			//                  y
-			double conv_output_x = mps_pose.GZWRAP_POS_X + BELT_OFFSET_SIDE * cos(mps_pose.GZWRAP_ROT_YAW)
-			                       + (BELT_LENGTH / 2 - PUCK_SIZE) * sin(mps_pose.GZWRAP_ROT_YAW);
-			double conv_output_y = mps_pose.GZWRAP_POS_Y + BELT_OFFSET_SIDE * sin(mps_pose.GZWRAP_ROT_YAW)
-			                       - (BELT_LENGTH / 2 - PUCK_SIZE) * cos(mps_pose.GZWRAP_ROT_YAW);
-			const gzwrap::Vector3d conv_output_pose(conv_output_x, conv_output_y, BELT_HEIGHT);
-
-			const gzwrap::Quaterniond conv_output_angle = mps_pose.GZWRAP_ROT_ADD(yaw_correction);
-
-			gzwrap::Pose3d output_pose(conv_output_pose, conv_output_angle);
-
-			//Calculate slide pose in case of an RS
-			bool           is_RS = model->GetName().find("RS") != std::string::npos;
-			gzwrap::Pose3d slide_pose(0, 0, 0, 0, 0, 0);
-			if (is_RS) {
-				double slide_x = mps_pose.GZWRAP_POS_X
-				                 + (BELT_OFFSET_SIDE + SLIDE_OFFSET) * cos(mps_pose.GZWRAP_ROT_YAW)
-				                 - (BELT_LENGTH / 2 - PUCK_SIZE) * sin(mps_pose.GZWRAP_ROT_YAW);
-				double slide_y = mps_pose.GZWRAP_POS_Y
-				                 + (BELT_OFFSET_SIDE + SLIDE_OFFSET) * sin(mps_pose.GZWRAP_ROT_YAW)
-				                 + (BELT_LENGTH / 2 - PUCK_SIZE) * cos(mps_pose.GZWRAP_ROT_YAW);
-				const gzwrap::Vector3d    slide_input_pose(slide_x, slide_y, BELT_HEIGHT);
-				const gzwrap::Quaterniond slide_angle = mps_pose.GZWRAP_ROT_SUB(yaw_correction);
-				slide_pose.Set(slide_input_pose, slide_angle);
-			}
+			std::shared_ptr<const StationFrames> frames = frame_registry_->frames(model);
+			bool is_RS = llsf_utils::machine_info(machine).type == llsf_utils::MachineType::RS;
 
 			gzwrap::Pose3d res_conv;
 			gzwrap::Pose3d res_slide;
 			gzwrap::Pose3d base_link_pose = base_link->GZWRAP_WORLD_POSE();
-			if (input_pose.GZWRAP_POS.Distance(camera_pose.GZWRAP_POS)
-			    < output_pose.GZWRAP_POS.Distance(camera_pose.GZWRAP_POS)) {
+			if (frames->input.GZWRAP_POS.Distance(camera_pose.GZWRAP_POS)
+			    < frames->output.GZWRAP_POS.Distance(camera_pose.GZWRAP_POS)) {
 				//printf("looking at input\n");
-				res_conv = input_pose - base_link_pose;
+				res_conv = frames->input - base_link_pose;
 				if (is_RS) {
-					res_slide = slide_pose - base_link_pose;
+					res_slide = frames->slide - base_link_pose;
 				}
 			} else {
 				//printf("looking at output\n");
-				res_conv = output_pose - base_link_pose;
+				res_conv = frames->output - base_link_pose;
 			}
 			//get position in the camera frame
 			llsf_msgs::ConveyorVisionResult conv_msg;
@@ -18,6 +18,8 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include "../mps/station_frames.h"
+
 #include <configurable/configurable.h>
 #include <llsf_msgs/ConveyorVisionResult.pb.h>
 #include <llsf_msgs/Pose3D.pb.h>
@@ -123,5 +125,8 @@ private:
 
 	///Publisher for conveyr results
 	transport::PublisherPtr conveyor_pub_;
+
+	///Cached conveyor and slide frames of the machines
+	std::shared_ptr<StationFrameRegistry> frame_registry_;
 };
 } // namespace gazebo
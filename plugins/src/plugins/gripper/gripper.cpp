@@ -81,6 +81,11 @@ Gripper::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	// grabJoint->SetPose(gazebo::math::Vector3(0.0,0.0,0.0));
 
 	action_duration_ = 3.0;
+
+	journal_ = gazebo_rcll::WorkpieceJournal::open(config->get_string("plugins/journal/file"),
+	                                               config->get_uint("plugins/journal/capacity"));
+	robot_state_ = RobotStateHub::instance(robotino_);
+	robot_state_->set_has_puck(false);
 }
 
 /** Called by the world update start event
@@ -178,6 +183,8 @@ Gripper::close()
 		printf("No Puck found in gripper.\n");
 		return;
 	}
+	// wake the puck in case it was frozen at rest
+	grippedPuck->SetEnabled(true);
 
 	//teleport puck into gripper center
 	setPuckPose();
@@ -208,6 +215,7 @@ Gripper::close()
 	grabJoint->SetLowStop(0, gazebo::math::Angle(0.0f));
 #endif
 
+	journal(gazebo_rcll::JournalEvent::GRIP);
 	sendHasPuck(true);
 }
 
@@ -220,6 +228,7 @@ Gripper::open()
 	grabJoint->Detach();
 
 	std::cout << "Opening gripper!" << std::endl;
+	journal(gazebo_rcll::JournalEvent::RELEASE);
 	grippedPuck.reset();
 
 	sendHasPuck(false);
@@ -272,6 +281,20 @@ Gripper::getNearestPuck()
 	}
 }
 
+/** Add an event of the gripped puck to the workpiece journal, if enabled.
+ * @param event the event
+ */
+void
+Gripper::journal(gazebo_rcll::JournalEvent event)
+{
+	if (journal_ && grippedPuck) {
+		journal_->record(event,
+		                 model_->GetWorld()->GZWRAP_SIM_TIME().Double(),
+		                 grippedPuck->GetName(),
+		                 robotino_->GetName());
+	}
+}
+
 void
 Gripper::sendHasPuck(bool has_puck)
 {
@@ -283,6 +306,7 @@ Gripper::sendHasPuck(bool has_puck)
 		msg.set_data(0);
 	}
 	has_puck_pub_->Publish(msg);
+	robot_state_->set_has_puck(has_puck);
 	//send info to mps
 	msgs::Joint joint_msg;
 	joint_msg.set_name(name_);
@@ -18,7 +18,10 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include "../robot-state/robot_state_hub.h"
+
 #include <configurable/configurable.h>
+#include <utils/misc/workpiece_journal.h>
 
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
@@ -85,6 +88,13 @@ private:
 
 	gazebo::physics::JointPtr grabJoint;
 
+	/// Lifecycle journal of the workpieces, nullptr if disabled
+	std::shared_ptr<gazebo_rcll::WorkpieceJournal> journal_;
+	void journal(gazebo_rcll::JournalEvent event);
+
+	/// Values for the fused state of the robot
+	std::shared_ptr<RobotStateHub> robot_state_;
+
 	static gazebo::physics::LinkPtr  getLinkEndingWith(physics::ModelPtr model, std::string link);
 	static gazebo::physics::JointPtr getJointEndingWith(physics::ModelPtr model, std::string link);
 
@@ -51,6 +51,15 @@ Gyro::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	this->name_ = model_->GetName();
 	printf("Loading Gyro Plugin of model %s\n", name_.c_str());
 
+	const std::string publication = "plugins/gyro/publication/";
+
+	publication_policy_ = std::unique_ptr<gazebo_rcll::PublicationPolicy>(
+	  new gazebo_rcll::PublicationPolicy(config->get_float(publication + "max_rate"),
+	                                     config->get_float(publication + "min_rate"),
+	                                     config->get_float(publication + "position_epsilon"),
+	                                     config->get_float(publication + "angle_epsilon")));
+	last_sample_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+
 	// Listen to the update event. This event is broadcast every
 	// simulation iteration.
 	this->update_connection_ =
@@ -63,10 +72,6 @@ Gyro::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 
 	//create publisher
 	this->gyro_pub_ = this->node_->Advertise<msgs::Vector3d>("~/RobotinoSim/Gyro/");
-
-	//init last sent time
-	last_sent_time_      = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
-	this->send_interval_ = 0.05;
 }
 
 /** Called by the world update start event
@@ -76,9 +81,10 @@ Gyro::OnUpdate(const common::UpdateInfo & /*_info*/)
 {
 	//Send gyro information to Fawkes
 	double time = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
-	if (time - last_sent_time_ > send_interval_) {
-		last_sent_time_ = time;
-		send_gyro();
+	// the policy only decides whether a sample is published, not when to sample
+	if (time - last_sample_time_ >= publication_policy_->min_interval()) {
+		last_sample_time_ = time;
+		send_gyro(time);
 	}
 }
 
@@ -89,14 +95,21 @@ Gyro::Reset()
 {
 }
 
+/** Send the gyro angles if they changed or the heartbeat is due.
+ * @param time the current simulation time
+ */
 void
-Gyro::send_gyro()
+Gyro::send_gyro(double time)
 {
 	if (gyro_pub_->HasConnections()) {
 		//Read gyro from simulation
-		float roll  = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_X;
-		float pitch = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Y;
-		float yaw   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
+		const gzwrap::Pose3d pose  = this->model_->GZWRAP_WORLD_POSE();
+		float                roll  = pose.GZWRAP_ROT_EULER_X;
+		float                pitch = pose.GZWRAP_ROT_EULER_Y;
+		float                yaw   = pose.GZWRAP_ROT_EULER_Z;
+		if (!publication_policy_->check(publication_, time, {}, {roll, pitch, yaw})) {
+			return;
+		}
 
 		//build message
 		msgs::Vector3d gyroMsg;
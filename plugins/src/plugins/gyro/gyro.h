@@ -19,6 +19,7 @@
  */
 
 #include <configurable/configurable.h>
+#include <utils/misc/publication_policy.h>
 
 #include <boost/bind.hpp>
 #include <gazebo/common/common.hh>
@@ -26,6 +27,7 @@
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <list>
+#include <memory>
 #include <stdio.h>
 #include <string.h>
 
@@ -58,15 +60,16 @@ private:
 	///name of the gyro and the communication channel
 	std::string name_;
 
-	///time variable to send in intervals
-	double last_sent_time_;
-
-	///time interval between to gyro msgs
-	double send_interval_;
+	///when the angles were last read, they are read with the max rate
+	double last_sample_time_;
+	///when and which angles were last sent
+	gazebo_rcll::PublicationState publication_;
+	///when to send the angles, only changes are sent
+	std::unique_ptr<gazebo_rcll::PublicationPolicy> publication_policy_;
 
 	//Gyro Stuff:
 	///Sending Gyro-angle to fawkes:
-	void send_gyro();
+	void send_gyro(double time);
 
 	///Publisher for GyroAngle
 	transport::PublisherPtr gyro_pub_;
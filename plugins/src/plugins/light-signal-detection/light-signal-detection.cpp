@@ -80,7 +80,8 @@ LightSignalDetection::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	                                        &LightSignalDetection::on_light_msg,
 	                                        this);
 
-	robot_pose_ = model_->GZWRAP_WORLD_POSE();
+	robot_pose_     = model_->GZWRAP_WORLD_POSE();
+	frame_registry_ = StationFrameRegistry::instance(model_->GetWorld());
 
 	//initial values:
 	visible_            = false;
@@ -155,16 +156,13 @@ LightSignalDetection::on_light_msg(ConstMachineInfoPtr &msg)
 	int   nearest_index = -1;
 	float min_dist      = 1000000;
 	for (int i = 0; i < msg->machines_size(); i++) {
-		llsf_msgs::Machine machine         = msg->machines(i);
-		std::string        machine_name    = machine.name();
-		std::string        light_link_name = machine_name + "::light_signals::link";
-		physics::EntityPtr light_entity =
-		  model_->GetWorld()->GZWRAP_ENTITY_BY_NAME(light_link_name.c_str());
-		if (light_entity == NULL) {
+		const std::string &                  machine_name = msg->machines(i).name();
+		std::shared_ptr<const StationFrames> frames       = frame_registry_->frames(machine_name);
+		if (!frames || !frames->have_light) {
 			//printf("Light-Signal-Detection can't find machine with name %s!\n", machine_name.c_str());
 			return;
 		}
-		gzwrap::Pose3d light_pose = light_entity->GZWRAP_WORLD_POSE();
+		const gzwrap::Pose3d &light_pose = frames->light;
 		float dist = light_pose.GZWRAP_POS.Distance(look_pos_x, look_pos_y, light_pose.GZWRAP_POS_Z);
 		if (dist < min_dist) {
 			min_dist      = dist;
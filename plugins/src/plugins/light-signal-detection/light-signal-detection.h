@@ -18,6 +18,8 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include "../mps/station_frames.h"
+
 #include <configurable/configurable.h>
 #include <llsf_msgs/MachineInfo.pb.h>
 #include <utils/misc/gazebo_api_wrappers.h>
@@ -99,6 +101,9 @@ private:
 	//robot position
 	gzwrap::Pose3d robot_pose_;
 
+	///Cached light signal frames of the machines
+	std::shared_ptr<StationFrameRegistry> frame_registry_;
+
 	///Publisher for Detected light signal
 	transport::PublisherPtr light_signal_pub_;
 };
@@ -30,6 +30,7 @@
 #include <llsf_msgs/SimTimeSync.pb.h>
 #include <protobuf_comm/client.h>
 #include <protobuf_comm/message_register.h>
+#include <utils/llsf/instance_ports.h>
 
 #include <gazebo/gazebo.hh>
 
@@ -49,7 +50,9 @@ typedef const boost::shared_ptr<llsf_msgs::SetOrderDeliveredByColor const>
 //config values
 #define PROTO_DIR config->get_string("plugins/llsf-refbox-comm/proto-dir").c_str()
 #define REFBOX_HOST config->get_string("plugins/llsf-refbox-comm/refbox-host").c_str()
-#define REFBOX_PORT config->get_int("plugins/llsf-refbox-comm/refbox-port")
+#define REFBOX_PORT \
+	llsf_utils::instance_port(config->get_uint("plugins/llsf-refbox-comm/refbox-port"), \
+	                          config->get_uint("plugins/instance/port-stride"))
 #define RECONNECT_INTERVAL config->get_int("plugins/llsf-refbox-comm/reconnect-interval") //in s
 //Max number of reconnect attempts (due to crash when tried to connect often)
 #define RECONNECT_ATTEMPTS config->get_int("plugins/llsf-refbox-comm/reconnect-attempts")
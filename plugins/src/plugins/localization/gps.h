@@ -18,23 +18,23 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
-#include <configurable/configurable.h>
+#include "pose_publisher.h"
 
-#include <boost/bind.hpp>
 #include <gazebo/common/common.hh>
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/physics.hh>
-#include <gazebo/transport/transport.hh>
-#include <list>
+#include <memory>
 #include <stdio.h>
-#include <string.h>
+#include <string>
 
 namespace gazebo {
 /**
-   * Provides ground Truth position
+   * Provides ground Truth position.
+   * The poses of all models are published by the PosePublisher of the world,
+   * the plugin only registers its model there.
    * @author Frederik Zwilling
    */
-class Gps : public ModelPlugin, public gazebo_rcll::ConfigurableAspect
+class Gps : public ModelPlugin
 {
 public:
 	Gps();
@@ -42,35 +42,15 @@ public:
 
 	//Overridden ModelPlugin-Functions
 	virtual void Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/);
-	virtual void OnUpdate(const common::UpdateInfo &);
 	virtual void Reset();
 
 private:
 	/// Pointer to the gazbeo model
 	physics::ModelPtr model_;
-	/// Pointer to the update event connection
-	event::ConnectionPtr update_connection_;
-	///Node for communication to fawkes
-	transport::NodePtr node_;
-	///WorldNode for communication to fawkes
-	transport::NodePtr world_node_;
 	///name of the gps and the communication channel
 	std::string name_;
 
-	///config value used to ckeck if WorldNode should be published
-	bool publish_world_node_;
-
-	///time variable to send in intervals
-	double last_sent_time_;
-
-	//Gps Stuff:
-	///Functions for sending information to fawkes:
-	void send_position();
-
-	///Publisher for GyroAngle
-	transport::PublisherPtr gps_pub_;
-
-	///Publisher for PuckPositions
-	transport::PublisherPtr gps_world_pub_;
+	///Publisher of the poses of all models of the world
+	std::shared_ptr<PosePublisher> pose_publisher_;
 };
 } // namespace gazebo
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *  pose_publisher.cpp - Batched ground truth poses of the models of a world
+ *
+ *  Created:   Sun 18 Oct 23:41:15 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "pose_publisher.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/bind.hpp>
+#include <map>
+
+using namespace gazebo;
+
+/** Get the pose publisher of a world.
+ * @param world the world to get the publisher for
+ * @return the publisher of the given world
+ */
+std::shared_ptr<PosePublisher>
+PosePublisher::instance(physics::WorldPtr world)
+{
+	static std::mutex                                           instances_mutex;
+	static std::map<std::string, std::weak_ptr<PosePublisher>> instances;
+
+	std::lock_guard<std::mutex>    lock{instances_mutex};
+	const std::string              name      = world->GZWRAP_NAME();
+	std::shared_ptr<PosePublisher> publisher = instances[name].lock();
+	if (!publisher) {
+		publisher       = std::shared_ptr<PosePublisher>(new PosePublisher(world));
+		instances[name] = publisher;
+	}
+	return publisher;
+}
+
+PosePublisher::PosePublisher(physics::WorldPtr world) : world_(world)
+{
+	const std::string publication = "plugins/gps/publication/";
+
+	publication_policy_ = std::unique_ptr<gazebo_rcll::PublicationPolicy>(
+	  new gazebo_rcll::PublicationPolicy(config->get_float(publication + "max_rate"),
+	                                     config->get_float(publication + "min_rate"),
+	                                     config->get_float(publication + "position_epsilon"),
+	                                     config->get_float(publication + "angle_epsilon")));
+
+	name_table_interval_  = config->get_float("plugins/gps/name_table_interval");
+	per_model_topics_     = config->get_bool("plugins/gps/per_model_topics");
+	publish_world_topic_  = config->get_bool("plugins/enable-public-object-pose-publisher");
+	last_sent_time_       = world_->GZWRAP_SIM_TIME().Double();
+	last_name_table_time_ = last_sent_time_;
+	name_table_due_       = true;
+
+	node_ = transport::NodePtr(new transport::Node());
+	// the namespace is set to the world name!
+	node_->Init(world_->GZWRAP_NAME());
+
+	batch_pub_ =
+	  node_->Advertise<gazsim_msgs::PoseBatch>(config->get_string("plugins/gps/topic_pose_batch"));
+	if (per_model_topics_ && publish_world_topic_) {
+		world_pub_ = node_->Advertise<msgs::Pose>("~/gazsim/gps/");
+	}
+
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&PosePublisher::on_update, this));
+}
+
+PosePublisher::~PosePublisher()
+{
+	update_connection_.reset();
+}
+
+/** Add a model whose pose to publish.
+ * @param model the model
+ */
+void
+PosePublisher::add_model(physics::ModelPtr model)
+{
+	std::unique_ptr<TrackedModel> tracked(new TrackedModel);
+	tracked->name  = model->GetName();
+	tracked->model = model;
+	if (per_model_topics_) {
+		// the topic the model's own gps plugin used to publish on
+		tracked->pub = node_->Advertise<msgs::Pose>("~/" + tracked->name + "/gazsim/gps/");
+	}
+
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (ids_.count(tracked->name)) {
+		return;
+	}
+	uint32_t id;
+	if (free_ids_.empty()) {
+		id = models_.size();
+		models_.emplace_back();
+	} else {
+		id = free_ids_.back();
+		free_ids_.pop_back();
+	}
+	ids_[tracked->name] = id;
+	models_[id]         = std::move(tracked);
+	added_.push_back(id);
+}
+
+/** Stop publishing the pose of a model.
+ * @param name the name of the model
+ */
+void
+PosePublisher::remove_model(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        id = ids_.find(name);
+	if (id == ids_.end()) {
+		return;
+	}
+	models_[id->second].reset();
+	free_ids_.push_back(id->second);
+	removed_.push_back(id->second);
+	ids_.erase(id);
+}
+
+/** Publish the poses which changed if the max rate allows it.
+ * The heartbeat of a model is published even if its pose did not change.
+ */
+void
+PosePublisher::on_update()
+{
+	common::Time sim_time = world_->GZWRAP_SIM_TIME();
+	double       time     = sim_time.Double();
+	if (time - last_sent_time_ < publication_policy_->min_interval()) {
+		return;
+	}
+	last_sent_time_ = time;
+
+	bool batch = batch_pub_->HasConnections();
+	bool world = world_pub_ && world_pub_->HasConnections();
+
+	gazsim_msgs::PoseBatch batch_msg;
+	batch_msg.set_sim_time_sec(sim_time.sec);
+	batch_msg.set_sim_time_nsec(sim_time.nsec);
+
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (!batch) {
+		// nobody would learn about the names, send them to the next subscriber
+		name_table_due_ = true;
+	} else if (name_table_due_ || time - last_name_table_time_ >= name_table_interval_) {
+		name_table_due_       = false;
+		last_name_table_time_ = time;
+		batch_msg.set_full_name_table(true);
+		for (uint32_t id = 0; id < models_.size(); id++) {
+			if (models_[id]) {
+				gazsim_msgs::PoseBatchName *name = batch_msg.add_names();
+				name->set_id(id);
+				name->set_name(models_[id]->name);
+			}
+		}
+	} else {
+		batch_msg.set_full_name_table(false);
+		for (uint32_t id : removed_) {
+			batch_msg.add_removed(id);
+		}
+		for (uint32_t id : added_) {
+			if (models_[id]) {
+				gazsim_msgs::PoseBatchName *name = batch_msg.add_names();
+				name->set_id(id);
+				name->set_name(models_[id]->name);
+			}
+		}
+	}
+	added_.clear();
+	removed_.clear();
+
+	for (uint32_t id = 0; id < models_.size(); id++) {
+		TrackedModel *tracked = models_[id].get();
+		if (!tracked) {
+			continue;
+		}
+		bool own = tracked->pub && tracked->pub->HasConnections();
+		if (!batch && !own && !world) {
+			continue;
+		}
+		physics::ModelPtr model = tracked->model.lock();
+		if (!model) {
+			continue;
+		}
+		physics::LinkPtr link = model->GetLink();
+		if (link && !link->GetEnabled()
+		    && !publication_policy_->heartbeat_due(tracked->publication, time)) {
+			continue;
+		}
+		const gzwrap::Pose3d pose = model->GZWRAP_WORLD_POSE();
+		if (!publication_policy_->check(tracked->publication,
+		                                time,
+		                                {pose.GZWRAP_POS_X, pose.GZWRAP_POS_Y, pose.GZWRAP_POS_Z},
+		                                {pose.GZWRAP_ROT_EULER_X,
+		                                 pose.GZWRAP_ROT_EULER_Y,
+		                                 pose.GZWRAP_ROT_EULER_Z})) {
+			continue;
+		}
+		if (batch) {
+			batch_msg.add_ids(id);
+			batch_msg.add_poses(pose.GZWRAP_POS_X);
+			batch_msg.add_poses(pose.GZWRAP_POS_Y);
+			batch_msg.add_poses(pose.GZWRAP_POS_Z);
+			batch_msg.add_poses(pose.GZWRAP_ROT_X);
+			batch_msg.add_poses(pose.GZWRAP_ROT_Y);
+			batch_msg.add_poses(pose.GZWRAP_ROT_Z);
+			batch_msg.add_poses(pose.GZWRAP_ROT_W);
+		}
+		if (own || world) {
+			msgs::Pose pose_msg;
+			pose_msg.set_name(tracked->name);
+			pose_msg.mutable_position()->set_x(pose.GZWRAP_POS_X);
+			pose_msg.mutable_position()->set_y(pose.GZWRAP_POS_Y);
+			pose_msg.mutable_position()->set_z(pose.GZWRAP_POS_Z);
+			pose_msg.mutable_orientation()->set_x(pose.GZWRAP_ROT_X);
+			pose_msg.mutable_orientation()->set_y(pose.GZWRAP_ROT_Y);
+			pose_msg.mutable_orientation()->set_z(pose.GZWRAP_ROT_Z);
+			pose_msg.mutable_orientation()->set_w(pose.GZWRAP_ROT_W);
+			if (own) {
+				tracked->pub->Publish(pose_msg);
+			}
+			if (world) {
+				world_pub_->Publish(pose_msg);
+			}
+		}
+	}
+	if (batch) {
+		batch_pub_->Publish(batch_msg);
+	}
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *  pose_publisher.h - Batched ground truth poses of the models of a world
+ *
+ *  Created:   Sun 18 Oct 23:41:15 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <configurable/configurable.h>
+#include <gazsim_msgs/PoseBatch.pb.h>
+#include <utils/misc/publication_policy.h>
+
+#include <boost/weak_ptr.hpp>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gazebo {
+
+/** Publisher of the ground truth poses of all models of a world.
+ * There is one publisher per world, the gps plugin of each model only
+ * registers its model. With the max rate of the publication policy, the poses
+ * of all models are read and those which changed meaningfully, or whose
+ * heartbeat is due, are published as a single gazsim_msgs::PoseBatch. The
+ * pose of a model whose physics are disabled, e.g. a frozen workpiece, is not
+ * even read until its heartbeat is due, it cannot move. Models are referred
+ * to by dense IDs, their names are only sent when they are added and in a
+ * longer interval for late subscribers. For existing consumers, each pose can
+ * also be published as msgs::Pose on the model's own topic.
+ */
+class PosePublisher : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	static std::shared_ptr<PosePublisher> instance(physics::WorldPtr world);
+	~PosePublisher();
+
+	void add_model(physics::ModelPtr model);
+	void remove_model(const std::string &name);
+
+private:
+	explicit PosePublisher(physics::WorldPtr world);
+	void on_update();
+
+	/** A model whose pose is published. */
+	struct TrackedModel
+	{
+		std::string                     name;
+		boost::weak_ptr<physics::Model> model;
+		/// when and which pose was last sent
+		gazebo_rcll::PublicationState publication;
+		/// publisher of the model's own topic, if per-model topics are enabled
+		transport::PublisherPtr pub;
+	};
+
+	physics::WorldPtr    world_;
+	event::ConnectionPtr update_connection_;
+
+	transport::NodePtr      node_;
+	transport::PublisherPtr batch_pub_;
+	transport::PublisherPtr world_pub_;
+
+	double last_sent_time_;
+	double last_name_table_time_;
+	/// true if the next batch must contain all names, e.g. for a new subscriber
+	bool name_table_due_;
+
+	/// When to publish the pose of a model
+	std::unique_ptr<gazebo_rcll::PublicationPolicy> publication_policy_;
+	/// Interval to resend all names of the batch
+	double name_table_interval_;
+	/// Publish each pose on the model's own topic too
+	bool per_model_topics_;
+	/// Publish each pose on the common topic in the world namespace too
+	bool publish_world_topic_;
+
+	std::mutex mutex_;
+	/// the models by ID, IDs of removed models are reused
+	std::vector<std::unique_ptr<TrackedModel>> models_;
+	std::vector<uint32_t>                      free_ids_;
+	std::unordered_map<std::string, uint32_t>  ids_;
+	/// models added and removed since the last batch
+	std::vector<uint32_t> added_;
+	std::vector<uint32_t> removed_;
+};
+
+} // namespace gazebo
@@ -0,0 +1,156 @@
+/***************************************************************************
+ *  actuation_manager.cpp - Applies the motor commands of all robots of a world
+ *
+ *  Created:   Mon 19 Oct 01:12:40 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "actuation_manager.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/bind.hpp>
+#include <cmath>
+#include <map>
+#include <string>
+
+using namespace gazebo;
+
+/** Get the actuation manager of a world.
+ * @param world the world to get the manager for
+ * @return the manager of the given world
+ */
+std::shared_ptr<ActuationManager>
+ActuationManager::instance(physics::WorldPtr world)
+{
+	static std::mutex                                              instances_mutex;
+	static std::map<std::string, std::weak_ptr<ActuationManager>> instances;
+
+	std::lock_guard<std::mutex>       lock{instances_mutex};
+	const std::string                 name    = world->GZWRAP_NAME();
+	std::shared_ptr<ActuationManager> manager = instances[name].lock();
+	if (!manager) {
+		manager         = std::shared_ptr<ActuationManager>(new ActuationManager(world));
+		instances[name] = manager;
+	}
+	return manager;
+}
+
+ActuationManager::ActuationManager(physics::WorldPtr world) : world_(world)
+{
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&ActuationManager::on_update, this));
+}
+
+ActuationManager::~ActuationManager()
+{
+	update_connection_.reset();
+}
+
+/** Add a robot, it stands still until it is commanded to move.
+ * @param model the model of the robot
+ * @return the ID of the robot for command() and remove_robot()
+ */
+uint32_t
+ActuationManager::add_robot(physics::ModelPtr model)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	uint32_t                    id;
+	if (free_ids_.empty()) {
+		id = models_.size();
+		models_.emplace_back();
+		active_.push_back(0);
+		vx_.push_back(0);
+		vy_.push_back(0);
+		vomega_.push_back(0);
+		yaw_.push_back(0);
+		world_vx_.push_back(0);
+		world_vy_.push_back(0);
+	} else {
+		id = free_ids_.back();
+		free_ids_.pop_back();
+	}
+	models_[id] = model;
+	active_[id] = 1;
+	vx_[id]     = 0;
+	vy_[id]     = 0;
+	vomega_[id] = 0;
+	return id;
+}
+
+/** Remove a robot, its velocity is not set anymore.
+ * @param id the ID of the robot
+ */
+void
+ActuationManager::remove_robot(uint32_t id)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	models_[id].reset();
+	active_[id] = 0;
+	free_ids_.push_back(id);
+}
+
+/** Set the commanded velocity of a robot.
+ * @param id the ID of the robot
+ * @param vx the forward velocity
+ * @param vy the sideways velocity
+ * @param vomega the angular velocity
+ */
+void
+ActuationManager::command(uint32_t id, float vx, float vy, float vomega)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (vx_[id] == vx && vy_[id] == vy && vomega_[id] == vomega) {
+		return;
+	}
+	vx_[id]     = vx;
+	vy_[id]     = vy;
+	vomega_[id] = vomega;
+	active_[id] = 1;
+}
+
+/** Apply the commanded velocities of all active robots. */
+void
+ActuationManager::on_update()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	const std::size_t           n = models_.size();
+
+	for (std::size_t i = 0; i < n; i++) {
+		if (active_[i]) {
+			physics::ModelPtr model = models_[i].lock();
+			yaw_[i]                 = model ? model->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z : 0;
+		}
+	}
+	// no branches and no model access, the compiler can vectorize this
+	for (std::size_t i = 0; i < n; i++) {
+		const float cs = std::cos(yaw_[i]);
+		const float sn = std::sin(yaw_[i]);
+		world_vx_[i]   = cs * vx_[i] - sn * vy_[i];
+		world_vy_[i]   = sn * vx_[i] + cs * vy_[i];
+	}
+	for (std::size_t i = 0; i < n; i++) {
+		if (!active_[i]) {
+			continue;
+		}
+		physics::ModelPtr model = models_[i].lock();
+		if (model) {
+			model->SetLinearVel(gzwrap::Vector3d(world_vx_[i], world_vy_[i], 0));
+			model->SetAngularVel(gzwrap::Vector3d(0, 0, vomega_[i]));
+		}
+		// a zero command only needs to be applied once
+		active_[i] = vx_[i] != 0 || vy_[i] != 0 || vomega_[i] != 0;
+	}
+}
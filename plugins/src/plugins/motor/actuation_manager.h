@@ -0,0 +1,73 @@
+/***************************************************************************
+ *  actuation_manager.h - Applies the motor commands of all robots of a world
+ *
+ *  Created:   Mon 19 Oct 01:12:40 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <boost/weak_ptr.hpp>
+#include <cstdint>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace gazebo {
+
+/** Manager applying the motor commands of all robots of a world.
+ * There is one manager per world, the motor plugin of each robot only
+ * registers its model and forwards the commands it receives. Once per step,
+ * the manager reads the yaw of each moving robot, transforms all commanded
+ * velocities into the world frame in one pass over contiguous arrays, and
+ * sets the resulting velocities. A zero command is applied once, robots
+ * standing still are skipped afterwards.
+ */
+class ActuationManager
+{
+public:
+	static std::shared_ptr<ActuationManager> instance(physics::WorldPtr world);
+	~ActuationManager();
+
+	uint32_t add_robot(physics::ModelPtr model);
+	void     remove_robot(uint32_t id);
+	void     command(uint32_t id, float vx, float vy, float vomega);
+
+private:
+	explicit ActuationManager(physics::WorldPtr world);
+	void on_update();
+
+	physics::WorldPtr    world_;
+	event::ConnectionPtr update_connection_;
+
+	std::mutex mutex_;
+	/// The robots by ID, IDs of removed robots are reused
+	std::vector<boost::weak_ptr<physics::Model>> models_;
+	std::vector<uint32_t>                        free_ids_;
+	/// 1 if the robot moves or a new zero command has to be applied
+	std::vector<uint8_t> active_;
+	/// commanded velocities in the robot frame
+	std::vector<float> vx_;
+	std::vector<float> vy_;
+	std::vector<float> vomega_;
+	/// yaw of each active robot and its commanded velocity in the world frame
+	std::vector<float> yaw_;
+	std::vector<float> world_vx_;
+	std::vector<float> world_vy_;
+};
+
+} // namespace gazebo
@@ -22,8 +22,6 @@
 
 #include <utils/misc/gazebo_api_wrappers.h>
 
-#include <math.h>
-
 using namespace gazebo;
 
 // Register this plugin to make it available in the simulator
@@ -36,6 +34,11 @@ Motor::Motor()
 Motor::~Motor()
 {
 	printf("Destructing Motor Plugin!\n");
+	if (actuation_) {
+		// no more commands for the ID, it may be reused
+		motor_move_sub_.reset();
+		actuation_->remove_robot(actuation_id_);
+	}
 }
 
 /** on loading of the plugin
@@ -51,55 +54,28 @@ Motor::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	this->name_ = model_->GetName();
 	printf("Loading Motor Plugin of model %s\n", name_.c_str());
 
-	// Listen to the update event. This event is broadcast every
-	// simulation iteration.
-	this->update_connection_ =
-	  event::Events::ConnectWorldUpdateBegin(boost::bind(&Motor::OnUpdate, this, _1));
+	// the commands are applied by the actuation manager in every step
+	actuation_    = ActuationManager::instance(model_->GetWorld());
+	actuation_id_ = actuation_->add_robot(model_);
 
 	//Create the communication Node for communication with fawkes
 	this->node_ = transport::NodePtr(new transport::Node());
 	//the namespace is set to the model name!
 	this->node_->Init(model_->GetWorld()->GZWRAP_NAME() + "/" + name_);
 
-	//initialize movement commands:
-	vx_     = 0.0;
-	vy_     = 0.0;
-	vomega_ = 0.0;
-
 	//create subscriber
 	this->motor_move_sub_ = this->node_->Subscribe(std::string("~/RobotinoSim/MotorMove/"),
 	                                               &Motor::on_motor_move_msg,
 	                                               this);
 }
 
-/** Called by the world update start event
- */
-void
-Motor::OnUpdate(const common::UpdateInfo & /*_info*/)
-{
-	//Apply movement command
-	float x, y;
-	float yaw = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-	//foward part
-	x = cos(yaw) * vx_;
-	y = sin(yaw) * vx_;
-	//sideways part
-	x += cos(yaw + 3.1415926f / 2) * vy_;
-	y += sin(yaw + 3.1415926f / 2) * vy_;
-	// Apply velocity to the model.
-	this->model_->SetLinearVel(gzwrap::Vector3d(x, y, 0));
-	this->model_->SetAngularVel(gzwrap::Vector3d(0, 0, vomega_));
-}
-
 /** on Gazebo reset
  */
 void
 Motor::Reset()
 {
 	//stop movement
-	vx_     = 0;
-	vy_     = 0;
-	vomega_ = 0;
+	actuation_->command(actuation_id_, 0, 0, 0);
 }
 
 /** Functions for recieving Messages (registerd via suscribers)
@@ -110,7 +86,5 @@ Motor::on_motor_move_msg(ConstVector3dPtr &msg)
 {
 	//printf("Got MotorMove Msg!!! %f %f %f\n", msg->x(), msg->y(), msg->z());
 	//Transform relative motion into ablosulte motion
-	vx_     = msg->x();
-	vy_     = msg->y();
-	vomega_ = msg->z();
+	actuation_->command(actuation_id_, msg->x(), msg->y(), msg->z());
 }
@@ -18,18 +18,23 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include "actuation_manager.h"
+
 #include <boost/bind.hpp>
 #include <gazebo/common/common.hh>
 #include <gazebo/gazebo.hh>
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <list>
+#include <memory>
 #include <stdio.h>
 #include <string.h>
 
 namespace gazebo {
 /** @class Motor
-   * Motor plugin for Gazebo
+   * Motor plugin for Gazebo.
+   * The commands are applied by the ActuationManager of the world together
+   * with those of all other robots.
    * @author Frederik Zwilling
    */
 class Motor : public ModelPlugin
@@ -43,14 +48,11 @@ public:
 
 	//Overridden ModelPlugin-Functions
 	virtual void Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/);
-	virtual void OnUpdate(const common::UpdateInfo &);
 	virtual void Reset();
 
 private:
 	/// Pointer to the Gazebo model
 	physics::ModelPtr model_;
-	/// Pointer to the update event connection
-	event::ConnectionPtr update_connection_;
 	///Node for communication to fawkes
 	transport::NodePtr node_;
 	///name of the motor and the communication channel
@@ -62,9 +64,9 @@ private:
 	///Suscriber for MotorMove Interfaces from Fawkes
 	transport::SubscriberPtr motor_move_sub_;
 
-	//current movement commands:
-	float vx_;
-	float vy_;
-	float vomega_;
+	///Manager applying the movement commands of all robots
+	std::shared_ptr<ActuationManager> actuation_;
+	///ID of this robot at the actuation manager
+	uint32_t actuation_id_;
 };
 } // namespace gazebo
@@ -20,11 +20,11 @@
 
 #include "mps_placement.h"
 
+#include <utils/llsf/machine_registry.h>
 #include <utils/misc/gazebo_api_wrappers.h>
 
 #include <cfloat>
 #include <fnmatch.h>
-#include <fstream>
 #include <iostream>
 #include <math.h>
 #include <time.h>
@@ -150,42 +150,31 @@ MpsPlacementPlugin::on_machine_info_msg(ConstMachineInfoPtr &msg)
 		ori -= M_PI / 2; // substracting 90° to solve mismatch between refbox rotation and gazebo.
 
 		//get machine type
-		std::string mps_type;
-		if (mps_name.find("BS") != std::string::npos) {
-			mps_type = "mps_base";
-		} else if (mps_name.find("CS") != std::string::npos) {
-			mps_type = "mps_cap";
-		} else if (mps_name.find("RS") != std::string::npos) {
-			mps_type = "mps_ring";
-		} else if (mps_name.find("DS") != std::string::npos) {
-			mps_type = "mps_delivery";
-		} else if (mps_name.find("SS") != std::string::npos) {
-			mps_type = "mps_storage";
-		} else {
+		llsf_utils::MachineId machine = llsf_utils::machine_id(mps_name);
+		if (machine == llsf_utils::INVALID_MACHINE) {
 			printf("Unknown mps-type: %s\n", mps_name.c_str());
 			return;
 		}
+		std::string mps_type = llsf_utils::machine_info(machine).model;
 
 		msgs::Factory spawn_mps_msg;
 		//get sdf, replaced name and set it to the factory message
-		std::string sdf_path = getenv("GAZEBO_RCLL");
-		sdf_path += "/models/" + mps_type + "/model.sdf";
-		std::ifstream raw_sdf_file(sdf_path.c_str());
-		std::string   new_sdf;
-		if (raw_sdf_file.is_open()) {
-			std::string raw_sdf((std::istreambuf_iterator<char>(raw_sdf_file)),
-			                    std::istreambuf_iterator<char>());
-			std::size_t name_pos = raw_sdf.find(mps_type);
-			if (name_pos == std::string::npos) {
-				printf("SDF file %s has no model named %s\n", sdf_path.c_str(), mps_type.c_str());
+		auto sdf_template = mps_templates_.find(mps_type);
+		if (sdf_template == mps_templates_.end()) {
+			std::shared_ptr<const std::string> raw_sdf = gazebo_rcll::model_sdf(mps_type);
+			if (!raw_sdf) {
+				printf("Cant find mps sdf file of model %s\n", mps_type.c_str());
 				return;
 			}
-			new_sdf = raw_sdf.erase(name_pos, mps_type.length()).insert(name_pos, mps_name);
-		} else {
-			printf("Cant find mps sdf file:%s\n", sdf_path.c_str());
-			return;
+			gazebo_rcll::SdfTemplate mps_template(*raw_sdf, {{mps_type, false}});
+			if (!mps_template.has_slot(0)) {
+				printf("SDF file of %s has no model named %s\n", mps_type.c_str(), mps_type.c_str());
+				return;
+			}
+			sdf_template = mps_templates_.emplace(mps_type, mps_template).first;
 		}
-		spawn_mps_msg.set_sdf(new_sdf.c_str());
+		sdf_template->second.render({mps_name}, spawn_sdf_);
+		spawn_mps_msg.set_sdf(spawn_sdf_);
 		spawn_mps_msg.set_clone_model_name(mps_name.c_str());
 #if GAZEBO_MAJOR_VERSION > 5
 		msgs::Set(spawn_mps_msg.mutable_pose(), ignition::math::Pose3d(coord_x, coord_y, 0, 0, 0, ori));
@@ -23,6 +23,7 @@
 #include <llsf_msgs/GameState.pb.h>
 #include <llsf_msgs/MachineInfo.pb.h>
 #include <utils/misc/gazebo_api_wrappers.h>
+#include <utils/misc/sdf_template.h>
 
 #include <boost/bind.hpp>
 #include <gazebo/common/common.hh>
@@ -30,6 +31,7 @@
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <list>
+#include <map>
 #include <stdio.h>
 #include <string.h>
 
@@ -93,6 +95,10 @@ private:
 	int                      random_seed_base_;
 	std::vector<std::string> placed_machines;
 
+	/// SDF templates of the machine models, filled in with the machine name
+	std::map<std::string, gazebo_rcll::SdfTemplate> mps_templates_;
+	std::string                                     spawn_sdf_;
+
 	// Create a publisher on the ~/factory topic to spawn models
 	transport::PublisherPtr factoryPub;
 	transport::PublisherPtr modelPub;
@@ -26,25 +26,22 @@
 
 #include <spdlog/spdlog.h>
 
-#include <chrono>
 #include <functional>
-#include <thread>
 
 using namespace gazebo;
 
 BaseStation::BaseStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf) : Mps(_parent, _sdf)
 {
 	station_ = Station::STATION_BASE;
-	start_server();
 }
 
 void
-BaseStation::process_command_in()
+BaseStation::process_command_in(const MpsCommand &cmd)
 {
 	SPDLOG_LOGGER_INFO(logger, "process_command_in called!");
-	Mps::process_command_in();
+	Mps::process_command_in(cmd);
 
-	uint16_t value = uint16_t(action_id_in_.GetValue());
+	uint16_t value = cmd.action_id;
 	if (value == 0) {
 		return;
 	}
@@ -57,44 +54,64 @@ BaseStation::process_command_in()
 		return;
 	}
 	SPDLOG_LOGGER_INFO(logger, "Dispensing base");
-	dispense_base(BaseColor(uint16_t(payload1_in_.GetValue())));
-	action_id_in_.SetValue((uint16_t)0);
-	payload1_in_.SetValue((uint16_t)0);
+	dispense_base(BaseColor(cmd.payload1));
+	in_registers_.reset_command();
 }
 
 void
 BaseStation::dispense_base(BaseColor color)
 {
 	SPDLOG_LOGGER_INFO(logger, "Dispensing base with color {}", color);
-	status_busy_in_.SetValue(true);
+	begin_operation();
 	switch (color) {
 	case BaseColor::RED: spawn_clr = gazsim_msgs::Color::RED; break;
 	case BaseColor::SILVER: spawn_clr = gazsim_msgs::Color::SILVER; break;
 	case BaseColor::BLACK: spawn_clr = gazsim_msgs::Color::BLACK; break;
 	}
-	gzwrap::Pose3d spawn_pose((input_x() + output_x()) / 2,
-	                          (input_y() + output_y()) / 2,
+	gzwrap::Pose3d belt_middle = frames()->middle;
+	gzwrap::Pose3d spawn_pose(belt_middle.GZWRAP_POS_X,
+	                          belt_middle.GZWRAP_POS_Y,
 	                          belt_height_ + (puck_height_ / 2),
 	                          0,
 	                          0,
 	                          0);
-	std::this_thread::sleep_for(dispense_duration);
-	// We wait for the workpiece to actually appear (on_new_puck).
-	spawning = spawn_puck(spawn_pose, spawn_clr);
+	scheduler_->schedule_in(dispense_duration, this, [this, spawn_pose] {
+		// We wait for the workpiece to actually appear (on_new_puck).
+		spawning = spawn_puck(spawn_pose, spawn_clr);
+		if (spawning.empty()) {
+			SPDLOG_LOGGER_WARN(logger, "Failed to dispense a base");
+			finish_operation();
+			return;
+		}
+		// do not stay busy forever if the announcement is lost
+		const std::string name = spawning;
+		scheduler_->schedule_in(spawn_timeout, this, [this, name] {
+			if (spawning != name) {
+				return;
+			}
+			SPDLOG_LOGGER_WARN(logger, "Dispensed base {} was not announced in time", name);
+			spawning.clear();
+			finish_operation();
+		});
+	});
 }
 
+/** Finish dispensing once the dispensed base is announced.
+ * An announcement arriving after spawn_timeout is ignored, the operation was
+ * finished by the timeout already.
+ */
 void
 BaseStation::on_new_puck(ConstNewPuckPtr &msg)
 {
-	if (spawning.empty()) {
+	if (spawning.empty() || spawning != msg->puck_name()) {
 		return;
 	}
 	Mps::on_new_puck(msg);
 
 	physics::ModelPtr new_wp = world_->GZWRAP_MODEL_BY_NAME(msg->puck_name());
-	if (new_wp && spawning == new_wp->GetName() && puck_in_middle(new_wp->GZWRAP_WORLD_POSE())) {
+	if (new_wp && puck_in_middle(new_wp->GZWRAP_WORLD_POSE())) {
 		wp_in_middle_ = new_wp;
-		spawning.clear();
 	}
-	status_busy_in_.SetValue(false);
+	spawning.clear();
+	finish_operation();
 }
@@ -34,7 +34,7 @@ class BaseStation : public Mps
 public:
 	BaseStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf);
 
-	void process_command_in() override;
+	void process_command_in(const MpsCommand &cmd) override;
 	void dispense_base(BaseColor color);
 
 private:
@@ -31,22 +31,44 @@ using namespace gazebo;
 CapStation::CapStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf) : Mps(_parent, _sdf)
 {
 	station_ = Station::STATION_CAP;
-	start_server();
-	spawn_puck(shelf_left_pose(), gazsim_msgs::Color::RED);
-	spawn_puck(shelf_middle_pose(), gazsim_msgs::Color::RED);
-	spawn_puck(shelf_right_pose(), gazsim_msgs::Color::RED);
 	workpiece_result_subscriber_ =
 	  node_->Subscribe(topic_puck_command_result_, &CapStation::on_puck_result, this);
-	stored_cap_color_  = gazsim_msgs::Color::NONE;
-	puck_spawned_time_ = created_time_;
+	stored_cap_color_ = gazsim_msgs::Color::NONE;
 }
 
+/** Fill the shelf once the station is started. */
 void
-CapStation::process_command_in()
+CapStation::on_started()
 {
-	Mps::process_command_in();
+	fill_shelf();
+}
 
-	uint16_t value = uint16_t(action_id_in_.GetValue());
+/** Put capped workpieces on all three shelf slots.
+ * The workpieces are materialized with their cap, so they do not need to be
+ * recognized by their pose once they are announced.
+ */
+void
+CapStation::fill_shelf()
+{
+	VirtualWorkpiece workpiece;
+	workpiece.base_color = gazsim_msgs::Color::RED;
+	if (machine_id_ == llsf_utils::machine_id("C-CS1")
+	    || machine_id_ == llsf_utils::machine_id("M-CS1")) {
+		workpiece.cap_color = gazsim_msgs::Color::GREY;
+	} else {
+		workpiece.cap_color = gazsim_msgs::Color::BLACK;
+	}
+	puck_in_shelf_left_   = materialize(workpiece, shelf_left_pose());
+	puck_in_shelf_middle_ = materialize(workpiece, shelf_middle_pose());
+	puck_in_shelf_right_  = materialize(workpiece, shelf_right_pose());
+}
+
+void
+CapStation::process_command_in(const MpsCommand &cmd)
+{
+	Mps::process_command_in(cmd);
+
+	uint16_t value = cmd.action_id;
 	if (value == 0) {
 		return;
 	}
@@ -58,7 +80,7 @@ CapStation::process_command_in()
 		//SPDLOG_LOGGER_WARN(logger, "Unexpected operation {} on station {}", oper, station_);
 		return;
 	}
-	auto op = Operation(uint16_t(payload1_in_.GetValue()));
+	auto op = Operation(cmd.payload1);
 	switch (op) {
 	case Operation::OPERATION_CAP_RETRIEVE: retrieve_cap(); break;
 	case Operation::OPERATION_CAP_MOUNT: mount_cap(); break;
@@ -80,7 +102,7 @@ CapStation::mount_cap()
 		return;
 	}
 	SPDLOG_LOGGER_INFO(logger, "Mounting cap");
-	status_busy_in_.SetValue(true);
+	begin_operation();
 	if (stored_cap_color_ != gazsim_msgs::Color::NONE) {
 		SPDLOG_LOGGER_INFO(logger,
 		                   "{} mounts cap on {} with color {}",
@@ -104,10 +126,8 @@ CapStation::mount_cap()
 	} else {
 		SPDLOG_LOGGER_WARN(logger, "{} can't mount cap without a cap loaded first", name_);
 	}
-	action_id_in_.SetValue((uint16_t)0);
-	payload1_in_.SetValue((uint16_t)0);
-	std::this_thread::sleep_for(cap_op_duration);
-	status_busy_in_.SetValue(false);
+	in_registers_.reset_command();
+	scheduler_->schedule_in(cap_op_duration, this, [this] { finish_operation(); });
 }
 
 void
@@ -118,77 +138,67 @@ CapStation::retrieve_cap()
 		return;
 	}
 	SPDLOG_LOGGER_INFO(logger, "Retrieving cap");
-	status_busy_in_.SetValue(true);
+	begin_operation();
 	gazsim_msgs::WorkpieceCommand cmd_msg = gazsim_msgs::WorkpieceCommand();
 	cmd_msg.set_puck_name(wp_in_middle_->GetName());
 	SPDLOG_LOGGER_INFO(logger, "{} retrieves cap from {}", name_, wp_in_middle_->GetName());
 	cmd_msg.set_command(gazsim_msgs::Command::REMOVE_CAP);
 	puck_cmd_pub_->Publish(cmd_msg);
-	action_id_in_.SetValue((uint16_t)0);
-	payload1_in_.SetValue((uint16_t)0);
-	std::this_thread::sleep_for(cap_op_duration);
-	status_busy_in_.SetValue(false);
+	in_registers_.reset_command();
+	scheduler_->schedule_in(cap_op_duration, this, [this] { finish_operation(); });
+}
+
+void
+CapStation::register_zones()
+{
+	Mps::register_zones();
+	add_zone(StationZone::SHELF_LEFT, shelf_left_pose(), 0.1);
+	add_zone(StationZone::SHELF_MIDDLE, shelf_middle_pose(), 0.1);
+	add_zone(StationZone::SHELF_RIGHT, shelf_right_pose(), 0.1);
 }
 
+/** Clear a shelf slot once its workpiece was taken.
+ * The shelf is refilled some time after its last workpiece was taken.
+ * @param zone the zone the workpiece entered or left
+ * @param event the event reported by the workpiece tracker
+ */
 void
-CapStation::OnUpdate(const common::UpdateInfo &info)
+CapStation::on_workpiece_event(StationZone zone, const WorkpieceEvent &event)
 {
-	Mps::OnUpdate(info);
-	if (model_->GetWorld()->GZWRAP_SIM_TIME().Double() - puck_spawned_time_ < SPAWN_PUCK_TIME) {
+	Mps::on_workpiece_event(zone, event);
+	if (event.type != WorkpieceEvent::LEFT) {
 		return;
 	}
-
-	if (puck_in_shelf_left_
-	    && !pose_hit(puck_in_shelf_left_->GZWRAP_WORLD_POSE(), shelf_left_pose(), 0.1))
-		puck_in_shelf_left_ = nullptr;
-	if (puck_in_shelf_middle_
-	    && !pose_hit(puck_in_shelf_middle_->GZWRAP_WORLD_POSE(), shelf_middle_pose(), 0.1))
-		puck_in_shelf_middle_ = nullptr;
-	if (puck_in_shelf_right_
-	    && !pose_hit(puck_in_shelf_right_->GZWRAP_WORLD_POSE(), shelf_right_pose(), 0.1))
-		puck_in_shelf_right_ = nullptr;
-	if (!puck_in_shelf_right_ && !puck_in_shelf_middle_ && !puck_in_shelf_left_) {
-		//shelf is empty -> refill
-		spawn_puck(shelf_left_pose(), gazsim_msgs::Color::RED);
-		spawn_puck(shelf_middle_pose(), gazsim_msgs::Color::RED);
-		spawn_puck(shelf_right_pose(), gazsim_msgs::Color::RED);
-		puck_spawned_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+	std::string *slot = nullptr;
+	switch (zone) {
+	case StationZone::SHELF_LEFT: slot = &puck_in_shelf_left_; break;
+	case StationZone::SHELF_MIDDLE: slot = &puck_in_shelf_middle_; break;
+	case StationZone::SHELF_RIGHT: slot = &puck_in_shelf_right_; break;
+	default: return;
+	}
+	if (slot->empty() || *slot != event.name) {
+		return;
+	}
+	slot->clear();
+	if (puck_in_shelf_left_.empty() && puck_in_shelf_middle_.empty()
+	    && puck_in_shelf_right_.empty()) {
+		scheduler_->schedule_in(std::chrono::seconds(SPAWN_PUCK_TIME), this, [this] { fill_shelf(); });
 	}
 }
 
+/** Handle a workpiece result on the world update thread.
+ * @param result the result, received on a transport thread
+ */
 void
-CapStation::on_new_puck(ConstNewPuckPtr &msg)
+CapStation::on_puck_result(ConstWorkpieceResultPtr &result)
 {
-	Mps::on_new_puck(msg);
-
-	//get model
-	physics::Model_V models = world_->GZWRAP_MODELS();
-	for (physics::ModelPtr model : models) {
-		if (model->GetName() == msg->puck_name()) {
-			gazsim_msgs::WorkpieceCommand cmd;
-			cmd.set_command(gazsim_msgs::Command::ADD_CAP);
-			if (name_.find("CS1") != std::string::npos) {
-				cmd.add_color(gazsim_msgs::Color::GREY);
-			} else if (name_.find("CS2") != std::string::npos) {
-				cmd.add_color(gazsim_msgs::Color::BLACK);
-			}
-			cmd.set_puck_name(msg->puck_name());
-			if (pose_in_shelf_left(model->GZWRAP_WORLD_POSE())) {
-				puck_in_shelf_left_ = model;
-				puck_cmd_pub_->Publish(cmd);
-			} else if (pose_in_shelf_middle(model->GZWRAP_WORLD_POSE())) {
-				puck_in_shelf_middle_ = model;
-				puck_cmd_pub_->Publish(cmd);
-			} else if (pose_in_shelf_right(model->GZWRAP_WORLD_POSE())) {
-				puck_in_shelf_right_ = model;
-				puck_cmd_pub_->Publish(cmd);
-			}
-		}
-	}
+	scheduler_->schedule_in(std::chrono::seconds(0), this, [this, result] {
+		process_puck_result(result);
+	});
 }
 
 void
-CapStation::on_puck_result(ConstWorkpieceResultPtr &result)
+CapStation::process_puck_result(ConstWorkpieceResultPtr &result)
 {
 	printf("CAPSTATION: on_puck_result: %s\n", result->puck_name().c_str());
 
@@ -211,35 +221,17 @@ CapStation::on_puck_result(ConstWorkpieceResultPtr &result)
 gzwrap::Pose3d
 CapStation::shelf_left_pose()
 {
-	return get_puck_world_pose(-0.1, 0, belt_height_ + 0.005);
+	return frames()->shelf[0];
 }
 
 gzwrap::Pose3d
 CapStation::shelf_middle_pose()
 {
-	return get_puck_world_pose(-0.2, 0, belt_height_ + 0.005);
+	return frames()->shelf[1];
 }
 
 gzwrap::Pose3d
 CapStation::shelf_right_pose()
 {
-	return get_puck_world_pose(-0.3, 0, belt_height_ + 0.005);
-}
-
-bool
-CapStation::pose_in_shelf_left(const gzwrap::Pose3d &puck_pose)
-{
-	return pose_hit(puck_pose, shelf_left_pose(), 0.05);
-}
-
-bool
-CapStation::pose_in_shelf_middle(const gzwrap::Pose3d &puck_pose)
-{
-	return pose_hit(puck_pose, shelf_middle_pose(), 0.05);
-}
-
-bool
-CapStation::pose_in_shelf_right(const gzwrap::Pose3d &puck_pose)
-{
-	return pose_hit(puck_pose, shelf_right_pose(), 0.05);
+	return frames()->shelf[2];
 }
@@ -36,30 +36,28 @@ class CapStation : public Mps
 public:
 	CapStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf);
 
-	void on_new_puck(ConstNewPuckPtr &msg);
-	void OnUpdate(const common::UpdateInfo &info);
 	void on_puck_result(ConstWorkpieceResultPtr &result);
-	void process_command_in() override;
+	void process_puck_result(ConstWorkpieceResultPtr &result);
+	void process_command_in(const MpsCommand &cmd) override;
+	void on_started() override;
+	void register_zones() override;
+	void on_workpiece_event(StationZone zone, const WorkpieceEvent &event) override;
 	void mount_cap();
 	void retrieve_cap();
+	void fill_shelf();
 
 	gzwrap::Pose3d shelf_left_pose();
 	gzwrap::Pose3d shelf_middle_pose();
 	gzwrap::Pose3d shelf_right_pose();
 
-	bool pose_in_shelf_left(const gzwrap::Pose3d &puck_pose);
-	bool pose_in_shelf_middle(const gzwrap::Pose3d &puck_pose);
-	bool pose_in_shelf_right(const gzwrap::Pose3d &puck_pose);
-
-	physics::ModelPtr puck_in_shelf_left_;
-	physics::ModelPtr puck_in_shelf_middle_;
-	physics::ModelPtr puck_in_shelf_right_;
+	/// names of the workpieces on the shelf, empty once taken, update thread only
+	std::string puck_in_shelf_left_;
+	std::string puck_in_shelf_middle_;
+	std::string puck_in_shelf_right_;
 
 	gazsim_msgs::Color stored_cap_color_;
 
 	transport::SubscriberPtr workpiece_result_subscriber_;
-
-	double puck_spawned_time_;
 };
 
 } // namespace gazebo
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *  command_queue.h - Bounded queue of OPC UA commands for a station
+ *
+ *  Created:   Sun 18 Oct 11:20:47 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace gazebo {
+
+/** A command written by the refbox into one of the register blocks. */
+struct MpsCommand
+{
+	/// The register block the command was written to
+	enum class Block { IN, BASIC };
+
+	Block    block;
+	uint32_t handle;
+	uint16_t action_id;
+	uint16_t payload1;
+	uint16_t payload2;
+	/// when the command was received
+	std::chrono::steady_clock::time_point received;
+};
+
+/** Bounded FIFO of commands, filled by the OPC UA subscription and drained
+ * on the world update thread by Mps::process_next_command().
+ * No command is lost if it arrives while the station is busy. If the queue
+ * is full, the new command is rejected and counted as dropped.
+ */
+class CommandQueue
+{
+public:
+	explicit CommandQueue(std::size_t capacity = 16)
+	: capacity_(capacity), dropped_(0)
+	{
+	}
+
+	void
+	set_capacity(std::size_t capacity)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		capacity_ = capacity;
+	}
+
+	/** Add a command to the queue.
+	 * @param cmd the command to add
+	 * @return false if the queue is full and the command was dropped
+	 */
+	bool
+	push(const MpsCommand &cmd)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (queue_.size() >= capacity_) {
+			++dropped_;
+			return false;
+		}
+		queue_.push_back(cmd);
+		return true;
+	}
+
+	/** Take the oldest command from the queue.
+	 * @param cmd is set to the oldest command
+	 * @return false if the queue is empty
+	 */
+	bool
+	try_pop(MpsCommand &cmd)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (queue_.empty()) {
+			return false;
+		}
+		cmd = queue_.front();
+		queue_.pop_front();
+		return true;
+	}
+
+	/** Get the number of commands dropped because the queue was full.
+	 * @return the number of dropped commands
+	 */
+	std::size_t
+	dropped()
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return dropped_;
+	}
+
+private:
+	std::mutex             mutex_;
+	std::deque<MpsCommand> queue_;
+	std::size_t            capacity_;
+	std::size_t            dropped_;
+};
+
+} // namespace gazebo
@@ -32,14 +32,13 @@ DeliveryStation::DeliveryStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf
 : Mps(_parent, _sdf)
 {
 	station_ = Station::STATION_DELIVERY;
-	start_server();
 }
 
 void
-DeliveryStation::process_command_in()
+DeliveryStation::process_command_in(const MpsCommand &cmd)
 {
-	Mps::process_command_in();
-	uint16_t value = uint16_t(action_id_in_.GetValue());
+	Mps::process_command_in(cmd);
+	uint16_t value = cmd.action_id;
 	if (value == 0) {
 		return;
 	}
@@ -48,7 +47,7 @@ DeliveryStation::process_command_in()
 	}
 	Operation oper = Operation(value - station_);
 	if (oper == Operation::OPERATION_DELIVER) {
-		deliver();
+		deliver(cmd.payload1);
 	} else {
 		//SPDLOG_LOGGER_WARN(logger, "Unexpected operation {} on station {}", oper, station_);
 		return;
@@ -60,11 +59,11 @@ DeliveryStation::process_command_in()
  * puck to the selected gate and send a DELIVER command to the refbox, then
  * reset the puck and the prepared status.
  * Otherwise, do nothing.
+ * @param slot_ the slot to deliver to
  */
 void
-DeliveryStation::deliver()
+DeliveryStation::deliver(uint16_t slot_)
 {
-	uint16_t slot_ = uint16_t(payload1_in_.GetValue());
 	if (slot_ != 1 && slot_ != 2 && slot_ != 3) {
 		SPDLOG_LOGGER_WARN(logger, "Unexpected slot__ {}", slot_);
 		return;
@@ -74,11 +73,22 @@ DeliveryStation::deliver()
 		SPDLOG_LOGGER_INFO(logger, "No workpiece in machine's input");
 		return;
 	}
-	status_busy_in_.SetValue(true);
-	action_id_in_.SetValue((uint16_t)0);
-	payload1_in_.SetValue((uint16_t)0);
-	std::this_thread::sleep_for(deliver_duration);
+	begin_operation();
+	in_registers_.reset_command();
+	scheduler_->schedule_in(deliver_duration, this, [this] { finish_deliver(); });
+}
+
+/** Move the delivered workpiece to the gate and report it to the refbox. */
+void
+DeliveryStation::finish_deliver()
+{
+	if (!wp_in_input_) {
+		SPDLOG_LOGGER_WARN(logger, "Workpiece to deliver vanished from machine's input");
+		finish_operation();
+		return;
+	}
 	// TODO use the right gate
+	wp_in_input_->SetEnabled(true);
 	wp_in_input_->SetWorldPose(get_puck_world_pose(0.3, -0.2));
 	SPDLOG_LOGGER_DEBUG(logger, "Sending delivery information for puck {}", wp_in_input_->GetName());
 	gazsim_msgs::WorkpieceCommand cmd_msg;
@@ -90,6 +100,9 @@ DeliveryStation::deliver()
 		cmd_msg.set_team_color(gazsim_msgs::Team::MAGENTA);
 	}
 	puck_cmd_pub_->Publish(cmd_msg);
+	// leave the workpiece at the gate for a moment, then return it to the pool
+	physics::ModelPtr delivered = wp_in_input_;
+	scheduler_->schedule_in(recycle_delay, this, [this, delivered] { dematerialize(delivered); });
 	wp_in_input_.reset();
-	status_busy_in_.SetValue(false);
+	finish_operation();
 }
@@ -32,8 +32,11 @@ class DeliveryStation : public Mps
 public:
 	DeliveryStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf);
 
-	void process_command_in();
-	void deliver();
+	void process_command_in(const MpsCommand &cmd);
+	void deliver(uint16_t slot);
+
+private:
+	void finish_deliver();
 };
 
 } // namespace gazebo
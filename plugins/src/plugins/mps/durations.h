@@ -22,9 +22,15 @@
 #include <chrono>
 
 namespace gazebo {
+// All durations are simulation time, see SimTimeScheduler.
 constexpr const std::chrono::milliseconds move_duration{2500};
 constexpr const std::chrono::milliseconds dispense_duration{2500};
+/// how long a base station waits for a dispensed base to be announced
+constexpr const std::chrono::milliseconds spawn_timeout{5000};
 constexpr const std::chrono::milliseconds cap_op_duration{3500};
 constexpr const std::chrono::milliseconds deliver_duration{3500};
 constexpr const std::chrono::milliseconds ring_op_duration{3500};
+constexpr const std::chrono::milliseconds recycle_delay{2000};
+/// how often a ring station checks whether a held base on its slide was released
+constexpr const std::chrono::milliseconds release_poll_interval{250};
 } // namespace gazebo
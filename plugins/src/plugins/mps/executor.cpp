@@ -0,0 +1,172 @@
+/***************************************************************************
+ *  executor.cpp - Thread pool running the station command tasks
+ *
+ *  Created:   Sun 18 Oct 13:52:26 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "executor.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <exception>
+#include <map>
+#include <stdio.h>
+#include <string>
+
+using namespace gazebo;
+
+/** Get the executor of a world.
+ * The executor is created on first use and destroyed together with the last
+ * station holding a reference to it.
+ * @param world the world to get the executor for
+ * @return the executor of the given world
+ */
+std::shared_ptr<Executor>
+Executor::instance(physics::WorldPtr world)
+{
+	static std::mutex                                      instances_mutex;
+	static std::map<std::string, std::weak_ptr<Executor>> instances;
+
+	std::lock_guard<std::mutex> lock{instances_mutex};
+	const std::string           name     = world->GZWRAP_NAME();
+	std::shared_ptr<Executor>   executor = instances[name].lock();
+	if (!executor) {
+		executor        = std::shared_ptr<Executor>(new Executor());
+		instances[name] = executor;
+	}
+	return executor;
+}
+
+Executor::Executor() : shutdown_(false)
+{
+	thread_ = std::thread(&Executor::run, this);
+}
+
+/** Destructor.
+ * Runs all remaining tasks and stops the thread.
+ */
+Executor::~Executor()
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		shutdown_ = true;
+	}
+	wakeup_.notify_all();
+	thread_.join();
+}
+
+/** Run a task on the helper thread after all tasks submitted before.
+ * @param task the task to run
+ */
+void
+Executor::submit(Task task)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		tasks_.push_back(std::move(task));
+	}
+	wakeup_.notify_one();
+}
+
+void
+Executor::run()
+{
+	while (true) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock{mutex_};
+			wakeup_.wait(lock, [this] { return !tasks_.empty() || shutdown_; });
+			if (tasks_.empty()) {
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		try {
+			task();
+		} catch (std::exception &e) {
+			printf("Executor: task failed: %s\n", e.what());
+		}
+	}
+}
+
+Strand::Strand(std::shared_ptr<Executor> executor)
+: executor_(executor), scheduled_(false), closed_(false)
+{
+}
+
+/** Run a task after all tasks posted before.
+ * @param task the task to run
+ */
+void
+Strand::post(Executor::Task task)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (closed_) {
+			return;
+		}
+		tasks_.push_back(std::move(task));
+		if (scheduled_) {
+			return;
+		}
+		scheduled_ = true;
+	}
+	executor_->submit([this] { run(); });
+}
+
+/** Drop all pending tasks and wait for the running task to finish.
+ * Afterwards, posted tasks are ignored and the strand can be destroyed.
+ */
+void
+Strand::close()
+{
+	std::unique_lock<std::mutex> lock{mutex_};
+	closed_ = true;
+	tasks_.clear();
+	idle_.wait(lock, [this] { return !scheduled_; });
+}
+
+void
+Strand::run()
+{
+	Executor::Task task;
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (closed_ || tasks_.empty()) {
+			scheduled_ = false;
+			idle_.notify_all();
+			return;
+		}
+		task = std::move(tasks_.front());
+		tasks_.pop_front();
+	}
+	try {
+		task();
+	} catch (std::exception &e) {
+		printf("Strand: task failed: %s\n", e.what());
+	}
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (closed_ || tasks_.empty()) {
+			scheduled_ = false;
+			idle_.notify_all();
+			return;
+		}
+	}
+	// Run one task at a time, so other strands get their turn in between.
+	executor_->submit([this] { run(); });
+}
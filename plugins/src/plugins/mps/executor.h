@@ -0,0 +1,83 @@
+/***************************************************************************
+ *  executor.h - Helper thread running the slow tasks of the stations
+ *
+ *  Created:   Sun 18 Oct 13:52:26 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <gazebo/physics/physics.hh>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace gazebo {
+
+/** Helper thread shared by all stations of a world.
+ * Station commands run on the world update thread, the helper thread only
+ * takes what would stall the world: starting the OPC UA servers and
+ * publishing the station metrics. Tasks run in the order they are submitted.
+ */
+class Executor
+{
+public:
+	typedef std::function<void()> Task;
+
+	static std::shared_ptr<Executor> instance(physics::WorldPtr world);
+	~Executor();
+
+	void submit(Task task);
+
+private:
+	Executor();
+	void run();
+
+	std::thread             thread_;
+	std::mutex              mutex_;
+	std::condition_variable wakeup_;
+	std::deque<Task>        tasks_;
+	bool                    shutdown_;
+};
+
+/** Run the tasks of one station on an Executor.
+ * Tasks posted to a strand are executed in order, one at a time, so the
+ * tasks of different stations take turns. A strand can be closed to drop its
+ * pending tasks, e.g. when its station is destroyed.
+ */
+class Strand
+{
+public:
+	explicit Strand(std::shared_ptr<Executor> executor);
+
+	void post(Executor::Task task);
+	void close();
+
+private:
+	void run();
+
+	std::shared_ptr<Executor>  executor_;
+	std::mutex                 mutex_;
+	std::condition_variable    idle_;
+	std::deque<Executor::Task> tasks_;
+	bool                       scheduled_;
+	bool                       closed_;
+};
+
+} // namespace gazebo
@@ -21,11 +21,13 @@
 #include "mps.h"
 
 #include "durations.h"
+#include "station_logger.h"
 
+#include <opc/ua/protocol/node_management.h>
 #include <opc/ua/protocol/variant.h>
-#include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <fnmatch.h>
 #include <fstream>
 #include <iostream>
@@ -39,27 +41,19 @@ using namespace gazebo;
 // Register this plugin to make it available in the simulator
 //GZ_REGISTER_MODEL_PLUGIN(Mps)
 
-const std::map<std::string, std::string> Mps::name_id_match = {
-  {"C-CS1I", "tag_01"},  {"C-CS1O", "tag_02"},  {"C-CS2I", "tag_17"},  {"C-CS2O", "tag_18"},
-  {"C-RS1I", "tag_33"},  {"C-RS1O", "tag_34"},  {"C-RS2I", "tag_177"}, {"C-RS2O", "tag_178"},
-  {"C-BSI", "tag_65"},   {"C-BSO", "tag_66"},   {"C-DSI", "tag_81"},   {"C-DSO", "tag_82"},
-  {"M-CS1I", "tag_97"},  {"M-CS1O", "tag_98"},  {"M-CS2I", "tag_113"}, {"M-CS2O", "tag_114"},
-  {"M-RS1I", "tag_129"}, {"M-RS1O", "tag_130"}, {"M-RS2I", "tag_145"}, {"M-RS2O", "tag_146"},
-  {"M-BSI", "tag_161"},  {"M-BSO", "tag_162"},  {"M-DSI", "tag_49"},   {"M-DSO", "tag_50"},
-  {"C-SSO", "tag_194"},  {"C-SSI", "tag_193"},  {"M-SSO", "tag_210"},  {"M-SSI", "tag_209"}};
-
 ///Constructor
 Mps::Mps(physics::ModelPtr _parent, sdf::ElementPtr)
-: shutdown_(false), model_(_parent), name_(model_->GetName()), sclt_in(this), sclt_base(this)
-{
-	auto sinks = spdlog::default_logger()->sinks();
-	sinks.push_back(
-	  std::make_shared<spdlog::sinks::basic_file_sink_mt>(fmt::format("gazebo-{}.log", name_), true));
-
-	logger = std::make_shared<spdlog::logger>(name_, sinks.begin(), sinks.end());
-	logger->set_pattern("[%c] [%^%l%$] [%n]: %v (%s:%# [%!])");
-	logger->set_level(spdlog::level::debug);
-	logger->flush_on(spdlog::level::info);
+: ready_(false),
+  operation_running_(false),
+  model_(_parent),
+  name_(model_->GetName()),
+  machine_id_(llsf_utils::machine_id(name_)),
+  input_tag_name_(llsf_utils::tag_model_name(llsf_utils::machine_info(machine_id_).input_tag)),
+  output_tag_name_(llsf_utils::tag_model_name(llsf_utils::machine_info(machine_id_).output_tag)),
+  sclt_in(this),
+  sclt_base(this)
+{
+	logger = create_station_logger(name_, config);
 	SPDLOG_LOGGER_INFO(logger, "Loading Mps Plugin of model {}", name_);
 
 	number_pucks_            = config->get_int("plugins/mps/number_pucks");
@@ -80,12 +74,15 @@ Mps::Mps(physics::ModelPtr _parent, sdf::ElementPtr)
 	  config->get_string("plugins/llsf-refbox-comm/topic-instruct-machine").c_str();
 	topic_puck_command_        = config->get_string("plugins/mps/topic_puck_command").c_str();
 	topic_puck_command_result_ = config->get_string("plugins/mps/topic_puck_command_result").c_str();
-	topic_joint_               = config->get_string("plugins/mps/topic_joint").c_str();
+	commands_.set_capacity(config->get_uint("plugins/mps/command_queue_size"));
+	metrics_interval_ = config->get_float("plugins/mps/metrics_interval");
 
 	// Listen to the update event. This event is broadcast every
 	// simulation iteration.
 	this->update_connection_ =
 	  event::Events::ConnectWorldUpdateBegin(boost::bind(&Mps::OnUpdate, this, _1));
+	this->flush_connection_ =
+	  event::Events::ConnectWorldUpdateEnd(boost::bind(&Mps::flush_registers, this));
 
 	//Create the communication Node for communication with fawkes
 	this->node_ = transport::NodePtr(new transport::Node());
@@ -103,19 +100,30 @@ Mps::Mps(physics::ModelPtr _parent, sdf::ElementPtr)
 	//this->instruct_machine_subscriber_ =
 	//  this->node_->Subscribe(topic_instruct_machine_, &Mps::on_instruct_machine_msg, this);
 
-	this->new_puck_subscriber_ = node_->Subscribe("~/new_puck", &Mps::on_new_puck, this);
-
 	//Create publisher to spawn tags
 	visPub_ = this->node_->Advertise<msgs::Visual>("~/visual", /*number of lights*/ 3 * 12);
 	//set_machne_state_pub_ =
 	//  this->node_->Advertise<llsf_msgs::SetMachineState>(topic_set_machine_state_);
 
 	//machine_reply_pub_ = this->node_->Advertise<llsf_msgs::MachineReply>(topic_machine_reply_);
-	world_ = model_->GetWorld();
+	world_             = model_->GetWorld();
+	scheduler_         = SimTimeScheduler::instance(world_);
+	frame_registry_    = StationFrameRegistry::instance(world_);
+	workpiece_tracker_ = WorkpieceTracker::instance(world_);
+	workpiece_pool_    = WorkpiecePool::instance(world_);
+	journal_           = gazebo_rcll::WorkpieceJournal::open(
+	  config->get_string("plugins/journal/file"), config->get_uint("plugins/journal/capacity"));
+	strand_            = std::unique_ptr<Strand>(new Strand(Executor::instance(world_)));
+	if (metrics_interval_ > 0) {
+		metrics_file_.open(fmt::format("gazebo-{}-metrics.jsonl", name_));
+		scheduler_->schedule_in(std::chrono::duration<float>(metrics_interval_), this, [this] {
+			publish_metrics();
+		});
+	}
 
-	factoryPub         = node_->Advertise<msgs::Factory>("~/factory");
-	puck_cmd_pub_      = node_->Advertise<gazsim_msgs::WorkpieceCommand>(topic_puck_command_);
-	joint_message_sub_ = node_->Subscribe(topic_joint_, &Mps::on_joint_msg, this);
+	puck_cmd_pub_ = node_->Advertise<gazsim_msgs::WorkpieceCommand>(topic_puck_command_);
+	// handled through the scheduler, so subscribe once it is there
+	new_puck_subscriber_ = node_->Subscribe("~/new_puck", &Mps::on_new_puck_msg, this);
 
 	//create joints to hold tags
 	tag_joint_input = model_->GetWorld()->GZWRAP_PHYSICS()->CreateJoint("revolute", model_);
@@ -125,118 +133,207 @@ Mps::Mps(physics::ModelPtr _parent, sdf::ElementPtr)
 	tag_joint_output = model_->GetWorld()->GZWRAP_PHYSICS()->CreateJoint("revolute", model_);
 	tag_joint_output->SetName("tag_joint_output");
 	tag_joint_output->SetModel(model_);
-
-	worker = std::thread(&Mps::worker_loop, this);
 }
+/** Remove a node and all nodes below it from the address space.
+ * @param node the node to remove
+ */
+static void
+delete_node_tree(const OpcUa::Node &node)
+{
+	std::vector<OpcUa::DeleteNodesItem> items;
+	std::vector<OpcUa::Node>            pending{node};
+	while (!pending.empty()) {
+		OpcUa::Node current = pending.back();
+		pending.pop_back();
+		for (const OpcUa::Node &child : current.GetChildren()) {
+			pending.push_back(child);
+		}
+		OpcUa::DeleteNodesItem item;
+		item.NodeId                 = current.GetId();
+		item.DeleteTargetReferences = true;
+		items.push_back(item);
+	}
+	node.GetServices()->NodeManagement()->DeleteNodes(items);
+}
+
 ///Destructor
 Mps::~Mps()
 {
-	std::unique_lock<std::mutex> lock{worker_mutex_};
-	shutdown_ = true;
-	lock.unlock();
-	notify_worker();
-	if (worker.joinable()) {
-		worker.join();
+	// wait for an asynchronous start, it creates the subscriptions
+	strand_->close();
+	// the server may outlive this station if it is shared
+	if (sub_in) {
+		sub_in->Delete();
+	}
+	if (sub_base) {
+		sub_base->Delete();
+	}
+	if (shared_node_) {
+		delete_node_tree(*shared_node_);
 	}
-	opcua_server_.Stop();
+	// no more commands can be queued, drop the pending continuations
+	scheduler_->cancel(this);
+	workpiece_tracker_->remove_zones(this);
+	logger->flush();
+	spdlog::drop(name_);
 	printf("Destructing Mps Plugin for %s!\n", this->name_.c_str());
 }
 
+/** Start the station.
+ * Called once the station is fully constructed. Starting the server and
+ * building the address space may take a while, so by default this runs on
+ * the executor's helper thread and the world continues to load and step in
+ * the meantime. on_started() is then run on the world update thread, like everything else
+ * touching the station's workpieces. Commands received before the station
+ * is ready stay queued and are run once it is, see is_ready().
+ */
+void
+Mps::start()
+{
+	register_zones();
+	auto started = [this] {
+		on_started();
+		ready_ = true;
+		SPDLOG_LOGGER_INFO(logger, "Station {} is ready", name_);
+		// run the commands which arrived while the station was starting
+		scheduler_->schedule_in(std::chrono::seconds(0), this, [this] { process_next_command(); });
+	};
+	if (config->get_bool("plugins/mps/async_start")) {
+		strand_->post([this, started] {
+			start_server();
+			scheduler_->schedule_in(std::chrono::seconds(0), this, started);
+		});
+	} else {
+		start_server();
+		started();
+	}
+}
+
+/** Check whether the station is started.
+ * @return true if the station's server is running and commands are accepted
+ */
+bool
+Mps::is_ready() const
+{
+	return ready_;
+}
+
+void
+Mps::on_started()
+{
+}
+
+/** Start the OPC UA server of the station or join the shared one.
+ * In shared mode, the station's address space is placed below
+ * Objects/<station name>. Stations listed in opcua_dedicated_servers keep
+ * their own server on the per-station endpoint, as expected by the refbox.
+ * All ports are shifted by the simulation instance, see plugins/instance.
+ */
 void
 Mps::start_server()
 {
-	opcua_server_.SetEndpoint(OpcUaConfig::get_endpoint(name_));
-	opcua_server_.SetServerURI(OpcUaConfig::get_URI(station_));
-	opcua_server_.Start();
-	init_opcua_server();
+	std::vector<std::string> dedicated = config->get_strings("plugins/mps/opcua_dedicated_servers");
+	unsigned int             port_base =
+	  llsf_utils::instance_port(config->get_uint("plugins/instance/opcua-port-base"),
+	                            config->get_uint("plugins/instance/port-stride"));
+	if (config->get_bool("plugins/mps/opcua_shared_server")
+	    && std::find(dedicated.begin(), dedicated.end(), name_) == dedicated.end()) {
+		opcua_server_ = OpcUaServerFactory::shared(OpcUaConfig::get_shared_endpoint(port_base));
+		shared_node_.reset(new OpcUa::Node(opcua_server_->GetObjectsNode().AddObject(2, name_)));
+		init_opcua_server(*shared_node_);
+	} else {
+		opcua_server_ = OpcUaServerFactory::dedicated(OpcUaConfig::get_endpoint(name_, port_base),
+		                                              OpcUaConfig::get_URI(station_));
+		init_opcua_server(opcua_server_->GetObjectsNode());
+	}
 }
 
+/** Create the station's variables and subscribe to the command registers.
+ * @param objects the node to create the DeviceSet object in
+ */
 void
-Mps::init_opcua_server()
-{
-	OpcUa::Node objects = opcua_server_.GetObjectsNode();
-	OpcUa::Node node    = objects.AddObject(2, "DeviceSet")
-	                     .AddObject(4, "CPX-E-CEC-C1-PN")
-	                     .AddObject(4, "Resources")
-	                     .AddObject(4, "Application")
-	                     .AddObject(3, "GlobalVars")
-	                     .AddObject(4, "G");
-
-	OpcUa::Node node_in   = node.AddObject(4, "In").AddObject(4, "p");
-	action_id_in_         = node_in.AddVariable(4, "ActionId", OpcUa::Variant((uint16_t)0));
-	barcode_in_           = node_in.AddVariable(4, "BarCode", OpcUa::Variant((uint16_t)0));
-	auto data_node_in     = node_in.AddObject(4, "Data");
-	payload1_in_          = data_node_in.AddVariable(0, "Payload1", OpcUa::Variant((uint16_t)0));
-	payload2_in_          = data_node_in.AddVariable(1, "Payload2", OpcUa::Variant((uint16_t)0));
-	error_in_             = node_in.AddVariable(4, "Error", OpcUa::Variant((uint8_t)0));
-	slidecount_in_        = node_in.AddVariable(4, "SlideCnt", OpcUa::Variant((uint16_t)0));
-	OpcUa::Node status_in = node_in.AddObject(4, "Status");
-	enable_in_            = status_in.AddVariable(4, "Enable", OpcUa::Variant(false));
-	status_error_in_      = status_in.AddVariable(4, "Error", OpcUa::Variant((uint8_t)0));
-	status_ready_in_      = status_in.AddVariable(4, "Ready", OpcUa::Variant(false));
-	status_busy_in_       = status_in.AddVariable(4, "Busy", OpcUa::Variant(false));
-
-	OpcUa::Node node_basic = node.AddObject(4, "Basic").AddObject(4, "p");
-	action_id_basic_       = node_basic.AddVariable(4, "ActionId", OpcUa::Variant((uint16_t)0));
-	barcode_basic_         = node_basic.AddVariable(4, "BarCode", OpcUa::Variant((uint16_t)0));
-	auto data_node_basic   = node_basic.AddObject(4, "Data");
-	payload1_basic_        = data_node_basic.AddVariable(0, "Payload1", OpcUa::Variant((uint16_t)0));
-	payload2_basic_        = data_node_basic.AddVariable(1, "Payload2", OpcUa::Variant((uint16_t)0));
-	error_basic_           = node_basic.AddVariable(4, "Error", OpcUa::Variant((uint8_t)0));
-	slidecount_basic_      = node_basic.AddVariable(4, "SlideCnt", OpcUa::Variant((uint16_t)0));
-	OpcUa::Node status_basic = node_basic.AddObject(4, "Status");
-	enable_basic_            = status_basic.AddVariable(4, "Enable", OpcUa::Variant(false));
-	status_error_basic_      = status_basic.AddVariable(4, "Error", OpcUa::Variant((uint8_t)0));
-	status_ready_basic_      = status_basic.AddVariable(4, "Ready", OpcUa::Variant(false));
-	status_busy_basic_       = status_basic.AddVariable(4, "Busy", OpcUa::Variant(false));
-
-	sclt_in.set_callback_funk(&Mps::notify_worker);
-	sub_in              = opcua_server_.CreateSubscription(100, sclt_in);
-	handel_action_id_in = sub_in->SubscribeDataChange(action_id_in_);
-
-	sclt_base.set_callback_funk(&Mps::notify_worker);
-	sub_base              = opcua_server_.CreateSubscription(100, sclt_base);
-	handel_action_id_base = sub_base->SubscribeDataChange(action_id_basic_);
+Mps::init_opcua_server(OpcUa::Node objects)
+{
+	OpcUa::Node node = objects.AddObject(2, "DeviceSet")
+	                  .AddObject(4, "CPX-E-CEC-C1-PN")
+	                  .AddObject(4, "Resources")
+	                  .AddObject(4, "Application")
+	                  .AddObject(3, "GlobalVars")
+	                  .AddObject(4, "G");
+
+	in_registers_.attach(node.AddObject(4, "In").AddObject(4, "p"));
+	basic_registers_.attach(node.AddObject(4, "Basic").AddObject(4, "p"));
+	metrics_.attach(node.AddObject(4, "Stats"));
+
+	// The server's publish timer does not accept an interval of 0, so the
+	// fastest possible interval is used instead.
+	unsigned int publishing_interval =
+	  std::max(1u, config->get_uint("plugins/mps/opcua_publishing_interval"));
+
+	// Notifications are delivered in the order the values changed. As the
+	// refbox writes the payloads before the action id, a command is usually
+	// queued with its own payloads. This is not guaranteed, though: changes
+	// within one publishing interval are coalesced, so of several action ids
+	// written in one interval only the latest is delivered and queued.
+	sclt_in.set_callback_funk(&Mps::on_data_change_in);
+	sub_in              = opcua_server_->CreateSubscription(publishing_interval, sclt_in);
+	handle1_in          = sub_in->SubscribeDataChange(in_registers_.node(RegisterBlock::PAYLOAD1));
+	handle2_in          = sub_in->SubscribeDataChange(in_registers_.node(RegisterBlock::PAYLOAD2));
+	handel_action_id_in = sub_in->SubscribeDataChange(in_registers_.node(RegisterBlock::ACTION_ID));
+
+	sclt_base.set_callback_funk(&Mps::on_data_change_basic);
+	sub_base              = opcua_server_->CreateSubscription(publishing_interval, sclt_base);
+	handle1_basic = sub_base->SubscribeDataChange(basic_registers_.node(RegisterBlock::PAYLOAD1));
+	handle2_basic = sub_base->SubscribeDataChange(basic_registers_.node(RegisterBlock::PAYLOAD2));
+	handel_action_id_base =
+	  sub_base->SubscribeDataChange(basic_registers_.node(RegisterBlock::ACTION_ID));
 }
 
 void
-Mps::process_command_in()
+Mps::process_command_in(const MpsCommand &cmd)
 {
-	uint16_t value = uint16_t(action_id_in_.GetValue());
+	uint16_t value = cmd.action_id;
 	if (value == 0) {
 		return;
 	}
 	SPDLOG_LOGGER_DEBUG(logger, "Processing command {}", value);
 	if (calculate_station_type_from_command(value) != station_) {
 		SPDLOG_LOGGER_INFO(logger, "Different station");
+		metrics_.command_rejected();
 		return;
 	}
 	if (value < station_) {
 		if (value != 0) {
 			SPDLOG_LOGGER_WARN(logger, "Unexpected action id {}", value);
 		}
+		metrics_.command_invalid();
 		return;
 	}
 	Operation op = Operation(value - station_);
 	SPDLOG_LOGGER_DEBUG(logger, "Processing op {}", op);
 	switch (op) {
 	case Operation::OPERATION_MOVE_CONVEYOR:
-		move_conveyor(MachineSide((uint16_t)payload1_in_.GetValue()));
+		move_conveyor(MachineSide(cmd.payload1));
 		break;
 	default: SPDLOG_LOGGER_DEBUG(logger, "Operation {}  is not implemented", op);
 	}
 }
 
 void
-Mps::process_command_base()
+Mps::process_command_base(const MpsCommand &)
 {
 }
 
 void
 Mps::move_conveyor(const MachineSide &side)
 {
-	status_busy_in_.SetValue(true);
-	std::this_thread::sleep_for(move_duration);
+	begin_operation();
+	scheduler_->schedule_in(move_duration, this, [this, side] { finish_move_conveyor(side); });
+}
+
+void
+Mps::finish_move_conveyor(const MachineSide &side)
+{
 	gzwrap::Pose3d    target_pose = output();
 	physics::ModelPtr wp;
 	switch (side) {
@@ -244,6 +341,7 @@ Mps::move_conveyor(const MachineSide &side)
 		wp = wp_in_middle_;
 		if (!wp) {
 			SPDLOG_LOGGER_WARN(logger, "No workpiece in machine's middle ({})", middle());
+			finish_operation();
 			return;
 		}
 		SPDLOG_LOGGER_INFO(logger, "Moving workpiece {} from middle to input", wp->GetName());
@@ -253,6 +351,7 @@ Mps::move_conveyor(const MachineSide &side)
 		wp = wp_in_input_;
 		if (!wp) {
 			SPDLOG_LOGGER_WARN(logger, "No workpiece in machine's input ({})", input());
+			finish_operation();
 			return;
 		}
 		SPDLOG_LOGGER_INFO(logger, "Moving workpiece {} from input to middle", wp->GetName());
@@ -262,6 +361,7 @@ Mps::move_conveyor(const MachineSide &side)
 		wp = wp_in_middle_;
 		if (!wp) {
 			SPDLOG_LOGGER_WARN(logger, "No workpiece in machine's middle ({})", middle());
+			finish_operation();
 			return;
 		}
 		SPDLOG_LOGGER_INFO(logger, "Moving workpiece {} from middle to output", wp->GetName());
@@ -274,18 +374,20 @@ Mps::move_conveyor(const MachineSide &side)
 		                   MachineSide::INPUT,
 		                   MachineSide::MIDDLE,
 		                   MachineSide::OUTPUT);
+		finish_operation();
 		return;
 	}
+	// wake the workpiece in case it was frozen at rest
+	wp->SetEnabled(true);
 	wp->SetWorldPose(target_pose);
 	SPDLOG_LOGGER_INFO(logger, "Moving workpiece {} to: {}|{}", wp->GetName(),
 	target_pose.Pos(), wp->WorldPose());
-	action_id_in_.SetValue((uint16_t)0);
-	payload1_in_.SetValue((uint16_t)0);
+	in_registers_.reset_command();
 	switch (side) {
 	case MachineSide::INPUT:
 		wp_in_middle_.reset();
 		wp_in_input_ = wp;
-		status_ready_in_.SetValue(true);
+		in_registers_.set_ready(true);
 		break;
 	case MachineSide::MIDDLE:
 		wp_in_input_.reset();
@@ -294,10 +396,10 @@ Mps::move_conveyor(const MachineSide &side)
 	case MachineSide::OUTPUT:
 		wp_in_middle_.reset();
 		wp_in_output_ = wp;
-		status_ready_in_.SetValue(true);
+		in_registers_.set_ready(true);
 		break;
 	}
-	status_busy_in_.SetValue(false);
+	finish_operation();
 }
 
 Station
@@ -306,24 +408,149 @@ Mps::calculate_station_type_from_command(uint16_t value)
 	return Station(value - (value % 100));
 }
 
+/** Handle a value delivered by the subscription of the In register block.
+ * Payloads are mirrored, a new action id is mirrored and queued as command
+ * together with the latest payloads.
+ * @param handle the handle of the monitored item
+ * @param value the new value
+ */
 void
-Mps::notify_worker()
+Mps::on_data_change_in(uint32_t handle, const OpcUa::Variant &value)
+{
+	if (handle == handle1_in) {
+		in_registers_.mirror(RegisterBlock::PAYLOAD1, uint16_t(value));
+	} else if (handle == handle2_in) {
+		in_registers_.mirror(RegisterBlock::PAYLOAD2, uint16_t(value));
+	} else if (handle == handel_action_id_in) {
+		in_registers_.mirror(RegisterBlock::ACTION_ID, uint16_t(value));
+		enqueue_command(MpsCommand{MpsCommand::Block::IN,
+		                           handle,
+		                           uint16_t(value),
+		                           in_registers_.get(RegisterBlock::PAYLOAD1),
+		                           in_registers_.get(RegisterBlock::PAYLOAD2),
+		                           std::chrono::steady_clock::now()});
+	}
+}
+
+/** Handle a value delivered by the subscription of the Basic register block.
+ * @param handle the handle of the monitored item
+ * @param value the new value
+ */
+void
+Mps::on_data_change_basic(uint32_t handle, const OpcUa::Variant &value)
+{
+	if (handle == handle1_basic) {
+		basic_registers_.mirror(RegisterBlock::PAYLOAD1, uint16_t(value));
+	} else if (handle == handle2_basic) {
+		basic_registers_.mirror(RegisterBlock::PAYLOAD2, uint16_t(value));
+	} else if (handle == handel_action_id_base) {
+		basic_registers_.mirror(RegisterBlock::ACTION_ID, uint16_t(value));
+		enqueue_command(MpsCommand{MpsCommand::Block::BASIC,
+		                           handle,
+		                           uint16_t(value),
+		                           basic_registers_.get(RegisterBlock::PAYLOAD1),
+		                           basic_registers_.get(RegisterBlock::PAYLOAD2),
+		                           std::chrono::steady_clock::now()});
+	}
+}
+
+void
+Mps::enqueue_command(const MpsCommand &cmd)
+{
+	// the station resets the action id to 0 once a command is done
+	if (cmd.action_id == 0) {
+		return;
+	}
+	if (!commands_.push(cmd)) {
+		SPDLOG_LOGGER_WARN(logger,
+		                   "Command queue full, dropping command {} ({} dropped so far)",
+		                   cmd.action_id,
+		                   commands_.dropped());
+		metrics_.command_dropped();
+		return;
+	}
+	// commands touch the station's workpieces, so they run on the update thread
+	scheduler_->schedule_in(std::chrono::seconds(0), this, [this] { process_next_command(); });
+}
+
+/** Write the registers changed during this step to the server.
+ * Called at the end of every simulation step.
+ */
+void
+Mps::flush_registers()
+{
+	in_registers_.flush();
+	basic_registers_.flush();
+	metrics_.poll(in_registers_.get(RegisterBlock::STATUS_BUSY), scheduler_->now());
+}
+
+/** Publish the metrics to the OPC UA variables and append them to the
+ * metrics file, then schedule the next run.
+ */
+void
+Mps::publish_metrics()
+{
+	const double sim_time = scheduler_->now();
+	strand_->post([this, sim_time] {
+		metrics_.publish();
+		metrics_file_ << metrics_.to_json(name_, sim_time) << std::endl;
+	});
+	scheduler_->schedule_in(std::chrono::duration<float>(metrics_interval_), this, [this] {
+		publish_metrics();
+	});
+}
+
+/** Process the queued commands in order.
+ * Runs on the world update thread, like the continuations of the operations
+ * and the workpiece events, so the station's state needs no lock. Commands
+ * which start an operation, e.g. a conveyor move, return once its
+ * continuation is scheduled. The following commands stay queued until the
+ * operation is finished, so the operations of a station never overlap.
+ * Nothing is processed before the station is ready.
+ */
+void
+Mps::process_next_command()
+{
+	MpsCommand cmd;
+	while (is_ready() && !operation_running_ && commands_.try_pop(cmd)) {
+		const double queue_wait =
+		  std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cmd.received)
+		    .count();
+		metrics_.command_started(cmd.action_id % 100, queue_wait, scheduler_->now());
+		switch (cmd.block) {
+		case MpsCommand::Block::BASIC: process_command_base(cmd); break;
+		case MpsCommand::Block::IN:
+			in_registers_.take_command(cmd.action_id, cmd.payload1, cmd.payload2);
+			process_command_in(cmd);
+			break;
+		}
+		metrics_.command_processed(operation_running_, scheduler_->now());
+	}
+}
+
+/** Start the operation of the current command.
+ * Sets the busy flag, the next queued command is only processed once the
+ * operation's continuation calls finish_operation().
+ */
+void
+Mps::begin_operation()
 {
-	worker_condition_.notify_one();
+	operation_running_ = true;
+	in_registers_.set_busy(true);
 }
 
+/** Finish the running operation.
+ * Clears the busy flag and processes the commands queued in the meantime.
+ * Every path of an operation's continuation must end here.
+ */
 void
-Mps::worker_loop()
+Mps::finish_operation()
 {
-	SPDLOG_LOGGER_INFO(logger, "worker_loop started!");
-	while (!shutdown_) {
-		std::unique_lock<std::mutex> lock{worker_mutex_};
-		worker_condition_.wait(lock);
-		lock.unlock();
-		process_command_base();
-		process_command_in();
+	in_registers_.set_busy(false);
+	if (operation_running_) {
+		operation_running_ = false;
+		scheduler_->schedule_in(std::chrono::seconds(0), this, [this] { process_next_command(); });
 	}
-	SPDLOG_LOGGER_INFO(logger, "worker_loop finished!");
 }
 
 /** Called by the world update start event
@@ -332,17 +559,14 @@ void
 Mps::OnUpdate(const common::UpdateInfo & /*_info*/)
 {
 	if (!grabbed_tags_) {
-		std::string input_tag_name  = name_id_match.at(name_ + "I");
-		std::string output_tag_name = name_id_match.at(name_ + "O");
-
-		physics::BasePtr input_tag  = model_->GetWorld()->GZWRAP_BASE_BY_NAME(input_tag_name);
-		physics::BasePtr output_tag = model_->GetWorld()->GZWRAP_BASE_BY_NAME(output_tag_name);
+		physics::BasePtr input_tag  = model_->GetWorld()->GZWRAP_BASE_BY_NAME(input_tag_name_);
+		physics::BasePtr output_tag = model_->GetWorld()->GZWRAP_BASE_BY_NAME(output_tag_name_);
 
 		if (input_tag && output_tag) {
 			//Spawn tags (in Init is to early because it would be spawned at origin)
 			printf("***** %s: Grabbing Tags\n", name_.c_str());
-			grabTag("mps_tag_input", name_ + "I", tag_joint_input);
-			grabTag("mps_tag_output", name_ + "O", tag_joint_output);
+			grabTag("mps_tag_input", input_tag_name_, tag_joint_input);
+			grabTag("mps_tag_output", output_tag_name_, tag_joint_output);
 			grabbed_tags_ = true;
 		} else {
 			printf("***** %s: Tags not there, yet\n", name_.c_str());
@@ -357,39 +581,88 @@ Mps::Reset()
 {
 }
 
-/** Functions for recieving puck locations Messages
- * @param msg message
+/** Register the zones of the station with the workpiece tracker.
+ * Stations do not move once loaded, so the zones are registered once.
  */
 void
-Mps::on_puck_msg(ConstPosePtr &msg)
+Mps::register_zones()
 {
-	if (!wp_in_input_ && puck_in_input(msg)) {
-		wp_in_input_ = world_->ModelByName(msg->name());
-		if (!wp_in_input_) {
-			SPDLOG_LOGGER_WARN(logger, "Workpiece {} is input, but could not find model!", msg->name());
-		} else {
-			SPDLOG_LOGGER_INFO(logger, "Found workpiece {} in input", wp_in_input_->GetName());
+	add_zone(StationZone::INPUT, input(), detect_tolerance_);
+	add_zone(StationZone::OUTPUT, output(), detect_tolerance_);
+}
+
+/** Watch a zone of the station for workpieces.
+ * @param zone the zone, passed to on_workpiece_event()
+ * @param center the center of the zone
+ * @param radius the radius of the zone
+ */
+void
+Mps::add_zone(StationZone zone, const gzwrap::Pose3d &center, double radius)
+{
+	workpiece_tracker_->add_zone(this,
+	                             center.GZWRAP_POS,
+	                             radius,
+	                             [this, zone](const WorkpieceEvent &event) {
+		                             journal(event.type == WorkpieceEvent::ENTERED
+		                                       ? gazebo_rcll::JournalEvent::ZONE_ENTER
+		                                       : gazebo_rcll::JournalEvent::ZONE_LEAVE,
+		                                     event.name,
+		                                     uint16_t(zone));
+		                             on_workpiece_event(zone, event);
+	                             });
+}
+
+/** Add an event of this station to the workpiece journal, if enabled.
+ * @param event the event
+ * @param workpiece the name of the workpiece
+ * @param value the color or zone, depending on the event
+ */
+void
+Mps::journal(gazebo_rcll::JournalEvent event, const std::string &workpiece, uint16_t value)
+{
+	if (journal_) {
+		journal_->record(event, world_->GZWRAP_SIM_TIME().Double(), workpiece, name_, value);
+	}
+}
+
+/** Track the workpieces on the input and output of the conveyor.
+ * @param zone the zone the workpiece entered or left
+ * @param event the event reported by the workpiece tracker
+ */
+void
+Mps::on_workpiece_event(StationZone zone, const WorkpieceEvent &event)
+{
+	if (zone == StationZone::INPUT) {
+		if (event.type == WorkpieceEvent::ENTERED && !wp_in_input_) {
+			wp_in_input_ = event.model;
+			SPDLOG_LOGGER_INFO(logger, "Found workpiece {} in input", event.name);
+		} else if (event.type == WorkpieceEvent::LEFT && wp_in_input_
+		           && event.name == wp_in_input_->GetName()) {
+			SPDLOG_LOGGER_INFO(logger, "Workpiece {} no longer in input", event.name);
+			wp_in_input_.reset();
+			in_registers_.set_ready(false);
+			// another workpiece may have been put next to the one that left
+			std::vector<physics::ModelPtr> remaining =
+			  workpiece_tracker_->workpieces_near(input().GZWRAP_POS, detect_tolerance_);
+			if (!remaining.empty()) {
+				wp_in_input_ = remaining.front();
+				SPDLOG_LOGGER_INFO(logger, "Found workpiece {} in input", wp_in_input_->GetName());
+			}
 		}
-	} else if (wp_in_input_ && msg->name() == wp_in_input_->GetName() && !puck_in_input(msg)) {
-		SPDLOG_LOGGER_INFO(logger, "Workpiece {} no longer in input", wp_in_input_->GetName());
-		wp_in_input_.reset();
-		status_ready_in_.SetValue(false);
-	} else if (wp_in_output_ && msg->name() == wp_in_output_->GetName() && !puck_in_output(msg)) {
-		SPDLOG_LOGGER_INFO(logger, "Workpiece {} no longer in output", wp_in_output_->GetName());
+	} else if (zone == StationZone::OUTPUT && event.type == WorkpieceEvent::LEFT && wp_in_output_
+	           && event.name == wp_in_output_->GetName()) {
+		SPDLOG_LOGGER_INFO(logger, "Workpiece {} no longer in output", event.name);
 		wp_in_output_.reset();
-		status_ready_in_.SetValue(false);
+		in_registers_.set_ready(false);
 	}
 }
 
 /**
- * Find the tag with the id matching to the tag_name (e.g. C-BSI), grap it to mount it at the side of the mps (where the link link_name is placed)
+ * Find the tag model tag_name (e.g. tag_65), grap it to mount it at the side of the mps (where the link link_name is placed)
  */
 void
 Mps::grabTag(std::string link_name, std::string tag_name, gazebo::physics::JointPtr joint)
 {
-	//get tag_id from tag_name
-	tag_name = name_id_match.at(tag_name);
-
 	//get link of mps
 	gazebo::physics::LinkPtr gripperLink = getLinkEndingWith(model_, link_name.c_str());
 	if (!gripperLink) {
@@ -430,56 +703,58 @@ Mps::grabTag(std::string link_name, std::string tag_name, gazebo::physics::Joint
 	// printf("MPS %s: attached tag %s\n", name_.c_str(), tag_name.c_str());
 }
 
-//compute locations of input and output (not sure about the sides jet)
+/** Get the frames of this station.
+ * @return the frames, computed once and cached by the frame registry
+ */
+std::shared_ptr<const StationFrames>
+Mps::frames()
+{
+	return frame_registry_->frames(model_);
+}
+
 float
 Mps::output_x()
 {
-	double mps_x   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_X;
-	double mps_ori = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-	return mps_x + belt_offset_side_ * cos(mps_ori) + (belt_length_ / 2 - puck_size_) * sin(mps_ori);
+	return frames()->output.GZWRAP_POS_X;
 }
 
 float
 Mps::output_y()
 {
-	double mps_y   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_Y;
-	double mps_ori = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-	return mps_y + belt_offset_side_ * sin(mps_ori) - (belt_length_ / 2 - puck_size_) * cos(mps_ori);
+	return frames()->output.GZWRAP_POS_Y;
 }
 
 float
 Mps::input_x()
 {
-	double mps_x   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_X;
-	double mps_ori = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-	return mps_x + belt_offset_side_ * cos(mps_ori) - (belt_length_ / 2 - puck_size_) * sin(mps_ori);
+	return frames()->input.GZWRAP_POS_X;
 }
 
 float
 Mps::input_y()
 {
-	double mps_y   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_Y;
-	double mps_ori = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-	return mps_y + belt_offset_side_ * sin(mps_ori) + (belt_length_ / 2 - puck_size_) * cos(mps_ori);
+	return frames()->input.GZWRAP_POS_Y;
 }
 
 gzwrap::Pose3d
 Mps::input()
 {
-	return gzwrap::Pose3d(input_x(), input_y(), belt_height_, 0, 0, 0);
+	gzwrap::Pose3d frame = frames()->input;
+	return gzwrap::Pose3d(frame.GZWRAP_POS_X, frame.GZWRAP_POS_Y, frame.GZWRAP_POS_Z, 0, 0, 0);
 }
 
 gzwrap::Pose3d
 Mps::output()
 {
-	return gzwrap::Pose3d(output_x(), output_y(), belt_height_, 0, 0, 0);
+	gzwrap::Pose3d frame = frames()->output;
+	return gzwrap::Pose3d(frame.GZWRAP_POS_X, frame.GZWRAP_POS_Y, frame.GZWRAP_POS_Z, 0, 0, 0);
 }
 
 gzwrap::Pose3d
 Mps::middle()
 {
-	return gzwrap::Pose3d(
-	  (input_x() + output_x()) / 2, (input_y() + output_y()) / 2, belt_height_, 0, 0, 0);
+	gzwrap::Pose3d frame = frames()->middle;
+	return gzwrap::Pose3d(frame.GZWRAP_POS_X, frame.GZWRAP_POS_Y, frame.GZWRAP_POS_Z, 0, 0, 0);
 }
 
 bool
@@ -490,32 +765,6 @@ Mps::pose_hit(const gzwrap::Pose3d &to_test, const gzwrap::Pose3d &reference, do
 	return (to_test.GZWRAP_POS - reference.GZWRAP_POS).GZWRAP_LENGTH() < tolerance;
 }
 
-bool
-Mps::puck_in_input(ConstPosePtr &pose)
-{
-	double dist =
-	  sqrt((pose->position().x() - input_x()) * (pose->position().x() - input_x())
-	       + (pose->position().y() - input_y()) * (pose->position().y() - input_y())
-	       + (pose->position().z() - belt_height_) * (pose->position().z() - belt_height_));
-	return dist < detect_tolerance_;
-}
-
-bool
-Mps::puck_in_output(ConstPosePtr &pose)
-{
-	double dist =
-	  sqrt((pose->position().x() - output_x()) * (pose->position().x() - output_x())
-	       + (pose->position().y() - output_y()) * (pose->position().y() - output_y())
-	       + (pose->position().z() - belt_height_) * (pose->position().z() - belt_height_));
-	return dist < detect_tolerance_;
-}
-
-bool
-Mps::puck_in_middle(ConstPosePtr &pose)
-{
-	return puck_in_middle(gazebo::msgs::ConvertIgn(*pose));
-}
-
 bool
 Mps::puck_in_input(const gzwrap::Pose3d &pose)
 {
@@ -534,85 +783,94 @@ Mps::puck_in_middle(const gzwrap::Pose3d &pose)
 	return (pose.GZWRAP_POS - middle().GZWRAP_POS).GZWRAP_LENGTH() < detect_tolerance_;
 }
 
+/** Handle a workpiece announcement on the world update thread.
+ * Announcements arrive on a transport thread, but the station's state may
+ * only be touched from the world update thread.
+ * @param msg the announcement
+ */
 void
-Mps::on_new_puck(ConstNewPuckPtr &msg)
+Mps::on_new_puck_msg(ConstNewPuckPtr &msg)
+{
+	scheduler_->schedule_in(std::chrono::seconds(0), this, [this, msg] { process_new_puck(msg); });
+}
+
+/** Finish materialized workpieces, then pass the announcement on to the station. */
+void
+Mps::process_new_puck(ConstNewPuckPtr &msg)
+{
+	VirtualWorkpiece workpiece;
+	{
+		std::lock_guard<std::mutex> lock{materialize_mutex_};
+		auto                        materializing = materializing_.find(msg->puck_name());
+		if (materializing == materializing_.end()) {
+			on_new_puck(msg);
+			return;
+		}
+		workpiece = materializing->second;
+		materializing_.erase(materializing);
+	}
+	for (gazsim_msgs::Color ring_color : workpiece.ring_colors) {
+		gazsim_msgs::WorkpieceCommand cmd;
+		cmd.set_command(gazsim_msgs::Command::ADD_RING);
+		cmd.add_color(ring_color);
+		cmd.set_puck_name(msg->puck_name());
+		puck_cmd_pub_->Publish(cmd);
+	}
+	if (workpiece.cap_color != gazsim_msgs::Color::NONE) {
+		gazsim_msgs::WorkpieceCommand cmd;
+		cmd.set_command(gazsim_msgs::Command::ADD_CAP);
+		cmd.add_color(workpiece.cap_color);
+		cmd.set_puck_name(msg->puck_name());
+		puck_cmd_pub_->Publish(cmd);
+	}
+	on_new_puck(msg);
+}
+
+void
+Mps::on_new_puck(ConstNewPuckPtr &)
 {
-	this->puck_subs_.push_back(this->node_->Subscribe(msg->gps_topic(), &Mps::on_puck_msg, this));
 }
 
 std::string
 Mps::spawn_puck(const gzwrap::Pose3d &spawn_pose, gazsim_msgs::Color base_color)
 {
 	printf("spawning puck for %s\n", name_.c_str());
-	msgs::Factory new_puck_msg;
-
-	//use the workpiece_base sdf and replace the model name
-	//get the new puck name
-	std::string new_name = "puck_" + std::to_string(rand() % 1000000);
-	//Get sdf content
-	std::string sdf_path = getenv("GAZEBO_RCLL");
-	sdf_path += "/models/workpiece_base/model.sdf";
-	std::ifstream raw_sdf_file(sdf_path.c_str());
-	//exchange name
-	std::string new_sdf;
-	if (raw_sdf_file.is_open()) {
-		std::string raw_sdf((std::istreambuf_iterator<char>(raw_sdf_file)),
-		                    std::istreambuf_iterator<char>());
-		std::string old_name = "workpiece_base";
-		std::size_t name_pos = raw_sdf.find(old_name);
-		if (name_pos == std::string::npos) {
-			return "";
-		}
-		new_sdf               = raw_sdf.erase(name_pos, old_name.length()).insert(name_pos, new_name);
-		std::string old_color = "1.0 0.35 0.0 1";
-		std::string new_color;
-		std::string color_string;
-		switch (base_color) {
-		case gazsim_msgs::Color::RED:
-			new_color    = "1.0 0.0 0.0 1";
-			color_string = "RED";
-			break;
-		case gazsim_msgs::Color::BLACK:
-			new_color    = "0.2 0.2 0.2 1";
-			color_string = "BLACK";
-			break;
-		case gazsim_msgs::Color::SILVER:
-			new_color    = "0.8 0.8 0.8 1";
-			color_string = "SILVER";
-			break;
-		default:
-			printf("%s should spawn with an unsupported base color %s\n",
-			       new_name.c_str(),
-			       gazsim_msgs::Color_Name(base_color).c_str());
-			return "";
-			break;
-		}
-		std::size_t color_pos;
-		while ((color_pos = new_sdf.find(old_color)) != std::string::npos) {
-			new_sdf   = new_sdf.erase(color_pos, old_color.length()).insert(color_pos, new_color);
-			color_pos = new_sdf.find(old_color);
-		}
-		std::string plugin_string = "<plugin name=\"Puck\" filename=\"libpuck.so\"/>";
-		std::size_t string_pos    = new_sdf.find(plugin_string);
-		new_sdf                   = new_sdf.erase(string_pos, plugin_string.length())
-		            .insert(string_pos,
-		                    "<plugin name=\"Puck\" filename=\"libpuck.so\"><baseColor>" + color_string
-		                      + "</baseColor></plugin>");
+	std::string name = workpiece_pool_->spawn(spawn_pose, base_color);
+	if (!name.empty()) {
+		journal(gazebo_rcll::JournalEvent::SPAWN, name, uint16_t(base_color));
+	}
+	return name;
+}
 
-	} else {
-		printf("Cant find workpiece_base sdf file:%s", sdf_path.c_str());
-		return "";
+/** Turn a virtual workpiece into a simulated one.
+ * The base is taken from the workpiece pool, rings and cap are added as soon
+ * as the workpiece is announced.
+ * @param workpiece the workpiece to materialize
+ * @param pose the pose to put the workpiece at
+ * @return the name of the workpiece model, empty if it could not be spawned
+ */
+std::string
+Mps::materialize(const VirtualWorkpiece &workpiece, const gzwrap::Pose3d &pose)
+{
+	std::string name = spawn_puck(pose, workpiece.base_color);
+	if (!name.empty()
+	    && (!workpiece.ring_colors.empty() || workpiece.cap_color != gazsim_msgs::Color::NONE)) {
+		std::lock_guard<std::mutex> lock{materialize_mutex_};
+		materializing_[name] = workpiece;
 	}
+	return name;
+}
 
-	new_puck_msg.set_sdf(new_sdf.c_str());
-	new_puck_msg.set_clone_model_name(new_name.c_str());
-#if GAZEBO_MAJOR_VERSION > 5 && GAZEBO_MAJOR_VERSION < 8
-	msgs::Set(new_puck_msg.mutable_pose(), spawn_pose.Ign());
-#else
-	msgs::Set(new_puck_msg.mutable_pose(), spawn_pose);
-#endif
-	factoryPub->Publish(new_puck_msg);
-	return new_name;
+/** Take a workpiece out of the simulation.
+ * The model is returned to the workpiece pool, the station keeps whatever
+ * it needs to know about the workpiece as a VirtualWorkpiece.
+ * @param workpiece the model of the workpiece
+ */
+void
+Mps::dematerialize(const physics::ModelPtr &workpiece)
+{
+	journal(gazebo_rcll::JournalEvent::RECYCLE, workpiece->GetName());
+	workpiece_pool_->checkin(workpiece);
 }
 
 gzwrap::Pose3d
@@ -620,39 +878,17 @@ Mps::get_puck_world_pose(double long_side, double short_side, double height)
 {
 	if (height == -1.0)
 		height = belt_height_;
-
-	double mps_x   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_X;
-	double mps_y   = this->model_->GZWRAP_WORLD_POSE().GZWRAP_POS_Y;
-	double mps_ori = this->model_->GZWRAP_WORLD_POSE().GZWRAP_ROT_EULER_Z;
-
-	double x = mps_x + (belt_offset_side_ + long_side) * cos(mps_ori)
-	           - ((belt_length_ + short_side) / 2 - puck_size_) * sin(mps_ori);
-	double y = mps_y + (belt_offset_side_ + long_side) * sin(mps_ori)
-	           + ((belt_length_ + short_side) / 2 - puck_size_) * cos(mps_ori);
-
-	return gzwrap::Pose3d(x, y, height, 0, 0, 0);
-}
-
-void
-Mps::on_joint_msg(ConstJointPtr &joint_msg)
-{
-	hold_pucks[joint_msg->id()] = joint_msg->child();
-	//printf("%s got joint command on joint %i with child %s\n", name_.c_str(), joint_msg->id(), joint_msg->child().c_str());
+	return frame_registry_->station_pose(*frames(), long_side, short_side, height);
 }
 
+/** Check whether a workpiece is held by a gripper.
+ * @param puck_name the name of the workpiece
+ * @return true if a gripper holds the workpiece
+ */
 bool
-Mps::is_puck_hold(std::string puck_name)
-{
-	//printf("%s is testing if %s is hold\n", name_.c_str(), puck_name.c_str());
-	for (auto iter : hold_pucks) {
-		//printf("%s is testing for %s\n", name_.c_str(), iter.second.c_str());
-		if (puck_name == iter.second.c_str()) {
-			//printf("%s is found %s in hold\n", name_.c_str(), iter.second.c_str());
-			return true;
-		}
-	}
-	//printf("%s did not find %s", name_.c_str(), puck_name.c_str());
-	return false;
+Mps::is_puck_hold(const std::string &puck_name)
+{
+	return workpiece_tracker_->is_held(puck_name);
 }
 
 inline bool
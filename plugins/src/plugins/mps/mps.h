@@ -21,8 +21,17 @@
 #ifndef MPS_H
 #define MPS_H
 
+#include "command_queue.h"
+#include "executor.h"
 #include "opcua_server_config.h"
+#include "register_block.h"
+#include "scheduler.h"
+#include "server_factory.h"
+#include "station_frames.h"
+#include "station_metrics.h"
 #include "subclient.h"
+#include "workpiece_pool.h"
+#include "workpiece_tracker.h"
 
 #include <configurable/configurable.h>
 #include <gazsim_msgs/NewPuck.pb.h>
@@ -31,17 +40,22 @@
 #include <llsf_msgs/MachineInfo.pb.h>
 #include <llsf_msgs/MachineReport.pb.h>
 #include <opc/ua/server/server.h>
+#include <utils/llsf/machine_registry.h>
 #include <utils/misc/gazebo_api_wrappers.h>
+#include <utils/misc/workpiece_journal.h>
 
+#include <atomic>
 #include <boost/bind.hpp>
-#include <condition_variable>
+#include <fstream>
 #include <gazebo/common/common.hh>
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <list>
 #include <map>
+#include <mutex>
 #include <stdio.h>
 #include <string.h>
+#include <vector>
 
 typedef const boost::shared_ptr<gazsim_msgs::NewPuck const> ConstNewPuckPtr;
 
@@ -52,6 +66,27 @@ enum class MachineSide {
 	MIDDLE = 2,
 	OUTPUT = 3,
 };
+
+/// Zones of a station in which workpieces are tracked
+enum class StationZone {
+	INPUT,
+	OUTPUT,
+	SLIDE,
+	SHELF_LEFT,
+	SHELF_MIDDLE,
+	SHELF_RIGHT,
+};
+
+/** A workpiece kept by a station as data only.
+ * It has no model and is not simulated until it is materialized.
+ */
+struct VirtualWorkpiece
+{
+	gazsim_msgs::Color              base_color;
+	std::vector<gazsim_msgs::Color> ring_colors;
+	/// NONE for a workpiece without cap
+	gazsim_msgs::Color cap_color;
+};
 /**
    * Plugin to control a simulated MPS
    * @author Frederik Zwilling
@@ -62,52 +97,79 @@ public:
 	Mps(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/);
 	virtual ~Mps();
 
+	void start();
+	bool is_ready() const;
+
 	//add objects and variants
-	void init_opcua_server();
+	void init_opcua_server(OpcUa::Node objects);
 	//set the end point and URI
 	void start_server();
 
 	virtual void OnUpdate(const common::UpdateInfo &);
 	virtual void Reset();
-	// with payload_in, action_id_in, ...
-	virtual void process_command_in();
-	// with payload_base, action_id_base, ...
-	virtual void process_command_base();
+	// command written to the In register block
+	virtual void process_command_in(const MpsCommand &cmd);
+	// command written to the Basic register block
+	virtual void process_command_base(const MpsCommand &cmd);
 
 	void move_conveyor(const MachineSide &side);
 
 protected:
+	/// called once the station's server is up, e.g. to spawn initial workpieces
+	virtual void on_started();
+	/// true once the station is started and accepts commands
+	std::atomic<bool> ready_;
+
+	/// finish a conveyor move once the move duration has passed
+	void finish_move_conveyor(const MachineSide &side);
+
 	// use action_id to calculate station type
 	Station calculate_station_type_from_command(uint16_t value);
 
-	void                    notify_worker();
-	virtual void            worker_loop();
-	std::mutex              worker_mutex_;
-	std::condition_variable worker_condition_;
-	bool                    shutdown_;
-
-	static const std::map<std::string, std::string> name_id_match;
+	/// called by the subscriptions for every delivered value
+	void         on_data_change_in(uint32_t handle, const OpcUa::Variant &value);
+	void         on_data_change_basic(uint32_t handle, const OpcUa::Variant &value);
+	void         enqueue_command(const MpsCommand &cmd);
+	void         process_next_command();
+	void         flush_registers();
+	void         publish_metrics();
+	CommandQueue commands_;
+
+	/// mark the station busy, queued commands wait until finish_operation()
+	void begin_operation();
+	/// clear busy and go on with the next queued command
+	void finish_operation();
+	/// true from begin_operation() until finish_operation(), update thread only
+	bool operation_running_;
 
 	/// Pointer to the gazbeo model
 	physics::ModelPtr model_;
 	/// Pointer to the update event connection
 	event::ConnectionPtr update_connection_;
+	/// Pointer to the update end event connection, used to flush the registers
+	event::ConnectionPtr flush_connection_;
 	///Node for communication
 	transport::NodePtr node_;
 	///name of the mps and the communication channel
 	const std::string name_;
+	///compact ID of the mps in the machine table
+	const llsf_utils::MachineId machine_id_;
+	///names of the models of the tags mounted at the input and output
+	const std::string input_tag_name_;
+	const std::string output_tag_name_;
 
 	// Mps Stuff:
 
-	/// Subscriber to get puck positions
-	std::vector<transport::SubscriberPtr> puck_subs_;
 	///// Subscriber to get machine infos
 	//transport::SubscriberPtr machine_info_subscriber_;
 	///// Subscriber to get machine infos
 	//transport::SubscriberPtr instruct_machine_subscriber_;
 
-	/// Handler for puck positions
-	virtual void on_puck_msg(ConstPosePtr &msg);
+	/// Register the zones of the station with the workpiece tracker
+	virtual void register_zones();
+	void         add_zone(StationZone zone, const gzwrap::Pose3d &center, double radius);
+	/// Handler for workpieces entering or leaving one of the station's zones
+	virtual void on_workpiece_event(StationZone zone, const WorkpieceEvent &event);
 	/// Handler for machine msgs
 	//void on_machine_msg(ConstMachineInfoPtr &msg);
 	/// Handler for machine Instruction msgs
@@ -116,6 +178,8 @@ protected:
 	//virtual void new_machine_info(ConstMachine &machine);
 
 	transport::SubscriberPtr new_puck_subscriber_;
+	void                     on_new_puck_msg(ConstNewPuckPtr &msg);
+	void                     process_new_puck(ConstNewPuckPtr &msg);
 	virtual void             on_new_puck(ConstNewPuckPtr &msg);
 
 	//void refbox_reply(ConstInstructMachinePtr &msg);
@@ -152,28 +216,43 @@ protected:
 	bool
 	pose_hit(const gzwrap::Pose3d &to_test, const gzwrap::Pose3d &reference, double tolerance = -1.0);
 
-	bool puck_in_input(ConstPosePtr &pose);
-	bool puck_in_output(ConstPosePtr &pose);
-	bool puck_in_middle(ConstPosePtr &pose);
 	bool puck_in_input(const gzwrap::Pose3d &pose);
 	bool puck_in_output(const gzwrap::Pose3d &pose);
 	bool puck_in_middle(const gzwrap::Pose3d &pose);
 
 	physics::WorldPtr world_;
 
-	std::string spawn_puck(const gzwrap::Pose3d &spawn_pose, enum gazsim_msgs::Color base_color);
+	/// Scheduler to run operation continuations in simulation time
+	std::shared_ptr<SimTimeScheduler> scheduler_;
+	/// Cached input, output and other frames of the stations
+	std::shared_ptr<StationFrameRegistry> frame_registry_;
+	std::shared_ptr<const StationFrames>  frames();
+	/// Reports workpieces entering and leaving the station's zones
+	std::shared_ptr<WorkpieceTracker> workpiece_tracker_;
+	/// Hands out recycled workpieces, spawns new ones if it is empty
+	std::shared_ptr<WorkpiecePool> workpiece_pool_;
+	/// Lifecycle journal of the workpieces, nullptr if disabled
+	std::shared_ptr<gazebo_rcll::WorkpieceJournal> journal_;
+	void journal(gazebo_rcll::JournalEvent event, const std::string &workpiece, uint16_t value = 0);
+	/// Runs the start and the metrics publication of this station on the shared executor
+	std::unique_ptr<Strand> strand_;
+
+	StationMetrics metrics_;
+	/// simulation time between two metrics dumps, 0 to disable them
+	float         metrics_interval_;
+	std::ofstream metrics_file_;
 
-	// Create a publisher on the ~/factory topic
-	transport::PublisherPtr factoryPub;
+	std::string spawn_puck(const gzwrap::Pose3d &spawn_pose, enum gazsim_msgs::Color base_color);
+	std::string materialize(const VirtualWorkpiece &workpiece, const gzwrap::Pose3d &pose);
+	void        dematerialize(const physics::ModelPtr &workpiece);
+	/// materialized workpieces whose rings and cap are added once they are announced
+	std::mutex                              materialize_mutex_;
+	std::map<std::string, VirtualWorkpiece> materializing_;
 
 	/// Publisher for puck command
 	transport::PublisherPtr puck_cmd_pub_;
 
-	transport::SubscriberPtr joint_message_sub_;
-	void                     on_joint_msg(ConstJointPtr &joint_msg);
-
-	std::map<u_int32_t, std::string> hold_pucks;
-	bool                             is_puck_hold(std::string puck_name);
+	bool is_puck_hold(const std::string &puck_name);
 
 	//stuff for grabing the tag to the right position
 	static gazebo::physics::LinkPtr  getLinkEndingWith(physics::ModelPtr model, std::string link);
@@ -210,33 +289,20 @@ protected:
 	std::string topic_instruct_machine_;
 	std::string topic_puck_command_;
 	std::string topic_puck_command_result_;
-	std::string topic_joint_;
 
+	/// workpieces on the conveyor, only touched from the world update thread
 	physics::ModelPtr wp_in_input_;
 	physics::ModelPtr wp_in_middle_;
 	physics::ModelPtr wp_in_output_;
 
-	OpcUa::UaServer opcua_server_;
-	OpcUa::Node     action_id_in_;
-	OpcUa::Node     barcode_in_;
-	OpcUa::Node     payload1_in_;
-	OpcUa::Node     payload2_in_;
-	OpcUa::Node     error_in_;
-	OpcUa::Node     slidecount_in_;
-	OpcUa::Node     enable_in_;
-	OpcUa::Node     status_error_in_;
-	OpcUa::Node     status_ready_in_;
-	OpcUa::Node     status_busy_in_;
-	OpcUa::Node     action_id_basic_;
-	OpcUa::Node     barcode_basic_;
-	OpcUa::Node     payload1_basic_;
-	OpcUa::Node     payload2_basic_;
-	OpcUa::Node     error_basic_;
-	OpcUa::Node     slidecount_basic_;
-	OpcUa::Node     enable_basic_;
-	OpcUa::Node     status_error_basic_;
-	OpcUa::Node     status_ready_basic_;
-	OpcUa::Node     status_busy_basic_;
+	/// the server the station runs on, possibly shared with other stations
+	std::shared_ptr<OpcUa::UaServer> opcua_server_;
+	/// the station's Objects/<name> node on a shared server, removed with the station
+	std::unique_ptr<OpcUa::Node> shared_node_;
+
+	/// mirrors of the register blocks, flushed to the server once per step
+	RegisterBlock in_registers_;
+	RegisterBlock basic_registers_;
 
 	SubscriptionClient             sclt_in;
 	OpcUa::Subscription::SharedPtr sub_in;
@@ -255,9 +321,6 @@ protected:
 	uint32_t handle2_basic;
 
 	std::shared_ptr<spdlog::logger> logger;
-
-private:
-	std::thread worker;
 };
 } // namespace gazebo
 
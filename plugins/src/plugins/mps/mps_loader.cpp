@@ -28,6 +28,8 @@
 #include "ring_station.h"
 #include "storage_station.h"
 
+#include <utils/llsf/machine_registry.h>
+
 #include <memory>
 
 using namespace gazebo;
@@ -38,26 +40,36 @@ GZ_REGISTER_MODEL_PLUGIN(MpsLoader)
 void
 MpsLoader::Load(physics::ModelPtr _parent, sdf::ElementPtr sdf)
 {
-	std::string name = _parent->GetName();
+	std::string           name = _parent->GetName();
+	llsf_utils::MachineId id   = llsf_utils::machine_id(name);
+	if (id == llsf_utils::INVALID_MACHINE) {
+		printf("unknown machine: %s\n", name.c_str());
+		return;
+	}
 	//set the machine type
-	if (name.find("BS") != std::string::npos) {
+	switch (llsf_utils::machine_info(id).type) {
+	case llsf_utils::MachineType::BS:
 		printf("detected machine type: base \n");
 		mps_ = std::make_unique<BaseStation>(_parent, sdf);
-	} else if (name.find("SS") != std::string::npos) {
+		break;
+	case llsf_utils::MachineType::SS:
 		printf("detected machine type: Storage \n");
 		mps_ = std::make_unique<StorageStation>(_parent, sdf);
-	} else if (name.find("CS") != std::string::npos) {
+		break;
+	case llsf_utils::MachineType::CS:
 		printf("detected machine type: cap \n");
 		mps_ = std::make_unique<CapStation>(_parent, sdf);
-	} else if (name.find("RS") != std::string::npos) {
+		break;
+	case llsf_utils::MachineType::RS:
 		printf("detected machine type: ring \n");
 		mps_ = std::make_unique<RingStation>(_parent, sdf);
-	} else if (name.find("DS") != std::string::npos) {
+		break;
+	case llsf_utils::MachineType::DS:
 		printf("detected machine type: delivery \n");
 		mps_ = std::make_unique<DeliveryStation>(_parent, sdf);
-	} else {
-		printf("unknown machine: %s\n", name.c_str());
+		break;
 	}
+	mps_->start();
 }
 
 void
@@ -1,4 +1,6 @@
 #pragma once
+#include <utils/llsf/instance_ports.h>
+
 #include <iostream>
 #include <string>
 
@@ -50,41 +52,31 @@ struct MachineTypeException : std::exception
 class OpcUaConfig
 {
 public:
+	/** Get the endpoint of a station's dedicated server.
+	 * @param name the name of the station, e.g. C-BS
+	 * @param port_base the port of C-BS, the other stations follow
+	 * @return the endpoint of the station
+	 */
 	static std::string
-	get_endpoint(std::string name)
+	get_endpoint(const std::string &name, unsigned int port_base = 4840)
 	{
-		std::string p = "opc.tcp://localhost:";
-		if (name == "C-BS")
-			return p + "4840/";
-		if (name == "C-CS1")
-			return p + "4841/";
-		if (name == "C-CS2")
-			return p + "4842/";
-		if (name == "C-RS1")
-			return p + "4843/";
-		if (name == "C-RS2")
-			return p + "4844/";
-		if (name == "C-DS")
-			return p + "4845/";
-		if (name == "C-SS")
-			return p + "4846/";
-		if (name == "M-BS")
-			return p + "4850/";
-		if (name == "M-CS1")
-			return p + "4851/";
-		if (name == "M-CS2")
-			return p + "4852/";
-		if (name == "M-RS1")
-			return p + "4853/";
-		if (name == "M-RS2")
-			return p + "4854/";
-		if (name == "M-DS")
-			return p + "4855/";
-		if (name == "M-SS")
-			return p + "4856";
-		throw MachineTypeException();
+		int offset = llsf_utils::station_port_offset(name);
+		if (offset < 0)
+			throw MachineTypeException();
+		return "opc.tcp://localhost:" + std::to_string(port_base + offset) + "/";
 	};
 
+	/** Get the endpoint of the server shared by all stations.
+	 * @param port_base the port of C-BS
+	 * @return the endpoint of the shared server
+	 */
+	static std::string
+	get_shared_endpoint(unsigned int port_base = 4840)
+	{
+		unsigned int port = port_base + llsf_utils::SHARED_PORT_OFFSET;
+		return "opc.tcp://localhost:" + std::to_string(port) + "/";
+	}
+
 	static std::string
 	get_URI(Station station)
 	{
@@ -0,0 +1,187 @@
+/***************************************************************************
+ *  register_block.cpp - Local mirror of an MPS OPC UA register block
+ *
+ *  Created:   Sun 18 Oct 12:04:39 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "register_block.h"
+
+#include <opc/ua/protocol/variant.h>
+
+using namespace gazebo;
+
+/** Convert a mirrored value to the type of the register in the address space.
+ * @param reg the register
+ * @param value the mirrored value
+ * @return the value with the register's type
+ */
+static OpcUa::Variant
+to_variant(RegisterBlock::Register reg, uint16_t value)
+{
+	switch (reg) {
+	case RegisterBlock::ERROR_CODE:
+	case RegisterBlock::STATUS_ERROR: return OpcUa::Variant((uint8_t)value);
+	case RegisterBlock::ENABLE:
+	case RegisterBlock::STATUS_READY:
+	case RegisterBlock::STATUS_BUSY: return OpcUa::Variant(value != 0);
+	default: return OpcUa::Variant(value);
+	}
+}
+
+/// The registers holding a command, in the order of command_
+static const RegisterBlock::Register command_registers[] = {RegisterBlock::ACTION_ID,
+                                                            RegisterBlock::PAYLOAD1,
+                                                            RegisterBlock::PAYLOAD2};
+
+RegisterBlock::RegisterBlock() : dirty_(0), reset_(false), attached_(false)
+{
+	for (unsigned int i = 0; i < REGISTER_COUNT; i++) {
+		values_[i]  = 0;
+		pending_[i] = 0;
+	}
+	for (auto &value : command_) {
+		value = 0;
+	}
+}
+
+/** Create the variables of the block in the address space.
+ * @param p the "p" object of the block, e.g. .../G/In/p
+ */
+void
+RegisterBlock::attach(OpcUa::Node p)
+{
+	nodes_[ACTION_ID]    = p.AddVariable(4, "ActionId", to_variant(ACTION_ID, 0));
+	nodes_[BAR_CODE]     = p.AddVariable(4, "BarCode", to_variant(BAR_CODE, 0));
+	OpcUa::Node data     = p.AddObject(4, "Data");
+	nodes_[PAYLOAD1]     = data.AddVariable(0, "Payload1", to_variant(PAYLOAD1, 0));
+	nodes_[PAYLOAD2]     = data.AddVariable(1, "Payload2", to_variant(PAYLOAD2, 0));
+	nodes_[ERROR_CODE]   = p.AddVariable(4, "Error", to_variant(ERROR_CODE, 0));
+	nodes_[SLIDE_COUNT]  = p.AddVariable(4, "SlideCnt", to_variant(SLIDE_COUNT, 0));
+	OpcUa::Node status   = p.AddObject(4, "Status");
+	nodes_[ENABLE]       = status.AddVariable(4, "Enable", to_variant(ENABLE, 0));
+	nodes_[STATUS_ERROR] = status.AddVariable(4, "Error", to_variant(STATUS_ERROR, 0));
+	nodes_[STATUS_READY] = status.AddVariable(4, "Ready", to_variant(STATUS_READY, 0));
+	nodes_[STATUS_BUSY]  = status.AddVariable(4, "Busy", to_variant(STATUS_BUSY, 0));
+	attached_            = true;
+}
+
+/** Get the address space node of a register, e.g. to subscribe to it.
+ * @param reg the register
+ * @return the node of the register
+ */
+const OpcUa::Node &
+RegisterBlock::node(Register reg) const
+{
+	return nodes_[reg];
+}
+
+/** Write a register.
+ * The value is visible to get() immediately and written to the server with
+ * the next flush().
+ * @param reg the register to write
+ * @param value the new value
+ */
+void
+RegisterBlock::set(Register reg, uint16_t value)
+{
+	values_[reg]  = value;
+	pending_[reg] = value;
+	dirty_ |= 1u << reg;
+}
+
+/** Update the mirror with a value delivered by the server.
+ * @param reg the register that changed
+ * @param value the value in the address space
+ */
+void
+RegisterBlock::mirror(Register reg, uint16_t value)
+{
+	values_[reg] = value;
+}
+
+/** Remember the command the station is about to handle.
+ * A later reset_command() only clears this command.
+ * @param action_id the action id of the command
+ * @param payload1 the first payload of the command
+ * @param payload2 the second payload of the command
+ */
+void
+RegisterBlock::take_command(uint16_t action_id, uint16_t payload1, uint16_t payload2)
+{
+	command_[0] = action_id;
+	command_[1] = payload1;
+	command_[2] = payload2;
+}
+
+/** Reset the command registers once the taken command has been handled.
+ * The registers are cleared with the next flush(), but only if the server
+ * still holds the taken command in all of them. If the refbox wrote any part
+ * of a new command in the meantime, the reset is dropped as a whole. The
+ * server is read at flush time, so neither a stale nor a missing notification
+ * of the subscription can cancel the reset or let it overwrite a new command.
+ * A refbox write between that read and the write of the reset is not
+ * detected, as is a new command equal to the taken one in all three registers.
+ */
+void
+RegisterBlock::reset_command()
+{
+	// keep a newer command the subscription already delivered
+	for (unsigned int i = 0; i < command_.size(); i++) {
+		uint16_t expected = command_[i];
+		values_[command_registers[i]].compare_exchange_strong(expected, 0);
+	}
+	reset_ = true;
+}
+
+/** Check whether the server still holds the taken command.
+ * @return true if the command registers in the address space hold the values
+ * passed to take_command()
+ */
+bool
+RegisterBlock::server_holds_command() const
+{
+	for (unsigned int i = 0; i < command_.size(); i++) {
+		if (uint16_t(nodes_[command_registers[i]].GetValue()) != command_[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Write all registers changed since the last flush to the server.
+ * A pending reset of the command registers is written as described for
+ * reset_command().
+ */
+void
+RegisterBlock::flush()
+{
+	if (!attached_) {
+		return;
+	}
+	if (reset_.exchange(false) && server_holds_command()) {
+		for (Register reg : command_registers) {
+			nodes_[reg].SetValue(to_variant(reg, 0));
+		}
+	}
+	uint32_t dirty = dirty_.exchange(0);
+	for (unsigned int i = 0; dirty != 0 && i < REGISTER_COUNT; i++) {
+		if (dirty & (1u << i)) {
+			Register reg = Register(i);
+			nodes_[reg].SetValue(to_variant(reg, pending_[reg]));
+			dirty &= ~(1u << i);
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *  register_block.h - Local mirror of an MPS OPC UA register block
+ *
+ *  Created:   Sun 18 Oct 12:04:39 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <opc/ua/node.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace gazebo {
+
+/** Mirror of one register block (In or Basic) of the MPS address space.
+ * Station code reads and writes the mirror only. Values written by the refbox
+ * are fed in by the subscription through mirror(), values written by the
+ * station are marked dirty and written to the server by flush(), which is
+ * called once per simulation step. Several writes to the same register within
+ * one step thus result in a single write to the server.
+ * The command registers are reset with reset_command(), which only clears the
+ * command taken with take_command(), never a newer one of the refbox.
+ */
+class RegisterBlock
+{
+public:
+	/// The registers of a block, in the order they are flushed
+	enum Register {
+		ACTION_ID,
+		BAR_CODE,
+		PAYLOAD1,
+		PAYLOAD2,
+		ERROR_CODE,
+		SLIDE_COUNT,
+		ENABLE,
+		STATUS_ERROR,
+		STATUS_READY,
+		STATUS_BUSY,
+		REGISTER_COUNT
+	};
+
+	RegisterBlock();
+
+	void               attach(OpcUa::Node p);
+	const OpcUa::Node &node(Register reg) const;
+
+	/** Get the current value of a register.
+	 * @param reg the register to read
+	 * @return the value, booleans are represented as 0 and 1
+	 */
+	uint16_t
+	get(Register reg) const
+	{
+		return values_[reg];
+	}
+	void set(Register reg, uint16_t value);
+	void mirror(Register reg, uint16_t value);
+	void flush();
+
+	void
+	set_busy(bool busy)
+	{
+		set(STATUS_BUSY, busy);
+	}
+	void
+	set_ready(bool ready)
+	{
+		set(STATUS_READY, ready);
+	}
+	void take_command(uint16_t action_id, uint16_t payload1, uint16_t payload2);
+	void reset_command();
+
+private:
+	bool server_holds_command() const;
+
+	std::array<OpcUa::Node, REGISTER_COUNT>           nodes_;
+	std::array<std::atomic<uint16_t>, REGISTER_COUNT> values_;
+	std::array<std::atomic<uint16_t>, REGISTER_COUNT> pending_;
+	std::atomic<uint32_t>                             dirty_;
+	std::array<std::atomic<uint16_t>, 3>              command_;
+	std::atomic<bool>                                 reset_;
+	std::atomic<bool>                                 attached_;
+};
+
+} // namespace gazebo
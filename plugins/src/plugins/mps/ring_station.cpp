@@ -28,15 +28,15 @@ using namespace gazebo;
 
 RingStation::RingStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf) : Mps(_parent, _sdf)
 {
-	station_ = Station::STATION_RING;
-	start_server();
+	station_        = Station::STATION_RING;
+	bases_on_slide_ = 0;
 }
 
 void
-RingStation::process_command_in()
+RingStation::process_command_in(const MpsCommand &cmd)
 {
-	Mps::process_command_in();
-	uint16_t value = uint16_t(action_id_in_.GetValue());
+	Mps::process_command_in(cmd);
+	uint16_t value = cmd.action_id;
 	if (value == 0) {
 		return;
 	}
@@ -48,11 +48,9 @@ RingStation::process_command_in()
 		return;
 	}
 
-	auto feeder   = uint16_t(payload1_in_.GetValue());
-	auto payload2 = uint16_t(payload2_in_.GetValue());
-	action_id_in_.SetValue(uint16_t(0));
-	payload1_in_.SetValue(uint16_t(0));
-	payload2_in_.SetValue(uint16_t(0));
+	auto feeder   = cmd.payload1;
+	auto payload2 = cmd.payload2;
+	in_registers_.reset_command();
 	gazsim_msgs::Color color;
 	if (payload2 == 1) {
 		color = gazsim_msgs::Color::BLUE;
@@ -89,14 +87,13 @@ RingStation::mount_ring(gazsim_msgs::Color color)
 		return;
 	}
 	SPDLOG_LOGGER_INFO(logger, "Mounting ring");
-	status_busy_in_.SetValue(true);
+	begin_operation();
 	gazsim_msgs::WorkpieceCommand cmd;
 	cmd.set_command(gazsim_msgs::Command::ADD_RING);
 	cmd.add_color(color);
 	cmd.set_puck_name(wp_in_middle_->GetName());
 	puck_cmd_pub_->Publish(cmd);
-	std::this_thread::sleep_for(ring_op_duration);
-	status_busy_in_.SetValue(false);
+	scheduler_->schedule_in(ring_op_duration, this, [this] { finish_operation(); });
 }
 
 void
@@ -127,27 +124,59 @@ RingStation::puck_on_slide(const gzwrap::Pose3d &pose)
 	return (pose.GZWRAP_POS - add_base_pose().GZWRAP_POS).GZWRAP_LENGTH() < detect_tolerance_;
 }
 
-bool
-RingStation::puck_on_slide(ConstPosePtr &pose)
+void
+RingStation::register_zones()
 {
-	return puck_on_slide(gazebo::msgs::ConvertIgn(*pose));
+	Mps::register_zones();
+	add_zone(StationZone::SLIDE, add_base_pose(), detect_tolerance_);
+}
+
+void
+RingStation::on_workpiece_event(StationZone zone, const WorkpieceEvent &event)
+{
+	Mps::on_workpiece_event(zone, event);
+	if (zone == StationZone::SLIDE && event.type == WorkpieceEvent::ENTERED && event.model) {
+		add_base(event.model);
+	}
 }
 
+/** Count a base fed into the slide.
+ * The base is only paid for, it is counted and returned to the pool. A base
+ * still held by a gripper is only added once it is released on the slide.
+ * @param base the base which entered the slide
+ */
 void
-RingStation::on_puck_msg(ConstPosePtr &msg)
+RingStation::add_base(const physics::ModelPtr &base)
 {
-	Mps::on_puck_msg(msg);
-	if (puck_on_slide(msg)
-	    && std::find(begin(wps_on_slide_), end(wps_on_slide_), msg->name()) == wps_on_slide_.end()) {
-		SPDLOG_LOGGER_INFO(logger, "Adding base to ring station {}", name_);
-		wps_on_slide_.insert(msg->name());
-		slidecount_in_.SetValue(uint16_t(wps_on_slide_.size()));
-		world_->ModelByName(msg->name())
-		  ->SetWorldPose(
-		    get_puck_world_pose(-0.35,
-		                        -0.1 * (1 + ((wps_on_slide_.size() - 1) % 3)),
-		                        mps_height_ + 1.05 * puck_height_ * (int)(wps_on_slide_.size() / 3)));
+	if (is_puck_hold(base->GetName())) {
+		if (held_bases_.insert(base->GetName()).second) {
+			add_base_when_released(base->GetName());
+		}
+		return;
 	}
+	SPDLOG_LOGGER_INFO(logger, "Adding base to ring station {}", name_);
+	in_registers_.set(RegisterBlock::SLIDE_COUNT, ++bases_on_slide_);
+	dematerialize(base);
+}
+
+/** Wait for a held base on the slide to be released.
+ * A base which is carried away instead is not added.
+ * @param name the name of the held base
+ */
+void
+RingStation::add_base_when_released(const std::string &name)
+{
+	scheduler_->schedule_in(release_poll_interval, this, [this, name] {
+		physics::ModelPtr base = world_->GZWRAP_MODEL_BY_NAME(name);
+		if (base && is_puck_hold(name)) {
+			add_base_when_released(name);
+			return;
+		}
+		held_bases_.erase(name);
+		if (base && puck_on_slide(base->GZWRAP_WORLD_POSE())) {
+			add_base(base);
+		}
+	});
 }
 
 gzwrap::Pose3d
@@ -25,6 +25,8 @@
 
 #include "mps.h"
 
+#include <set>
+
 namespace gazebo {
 
 class RingStation : public Mps
@@ -32,20 +34,24 @@ class RingStation : public Mps
 public:
 	RingStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf);
 
-	void           process_command_in() override;
+	void           process_command_in(const MpsCommand &cmd) override;
 	gzwrap::Pose3d add_base_pose();
 
 	void publish_indicator(bool active, int number);
-	/// Handler for puck positions
-	void on_puck_msg(ConstPosePtr &msg) override;
 
 protected:
+	void register_zones() override;
+	void on_workpiece_event(StationZone zone, const WorkpieceEvent &event) override;
 	bool puck_on_slide(const gzwrap::Pose3d &pose);
-	bool puck_on_slide(ConstPosePtr &pose);
 
 private:
-	void                  mount_ring(gazsim_msgs::Color);
-	std::set<std::string> wps_on_slide_;
+	void mount_ring(gazsim_msgs::Color);
+	void add_base(const physics::ModelPtr &base);
+	void add_base_when_released(const std::string &name);
+	/// bases fed into the slide, kept as a count only
+	uint16_t bases_on_slide_;
+	/// bases on the slide still held by a gripper
+	std::set<std::string> held_bases_;
 };
 
 } // namespace gazebo
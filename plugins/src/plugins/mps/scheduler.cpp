@@ -0,0 +1,124 @@
+/***************************************************************************
+ *  scheduler.cpp - Run MPS continuations at a given simulation time
+ *
+ *  Created:   Sun 18 Oct 10:02:11 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "scheduler.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/bind.hpp>
+#include <vector>
+
+using namespace gazebo;
+
+/** Get the scheduler of a world.
+ * The scheduler is created on first use and destroyed together with the last
+ * station holding a reference to it.
+ * @param world the world to get the scheduler for
+ * @return the scheduler of the given world
+ */
+std::shared_ptr<SimTimeScheduler>
+SimTimeScheduler::instance(physics::WorldPtr world)
+{
+	static std::mutex                                              instances_mutex;
+	static std::map<std::string, std::weak_ptr<SimTimeScheduler>> instances;
+
+	std::lock_guard<std::mutex>       lock{instances_mutex};
+	const std::string                 name      = world->GZWRAP_NAME();
+	std::shared_ptr<SimTimeScheduler> scheduler = instances[name].lock();
+	if (!scheduler) {
+		scheduler       = std::shared_ptr<SimTimeScheduler>(new SimTimeScheduler(world));
+		instances[name] = scheduler;
+	}
+	return scheduler;
+}
+
+SimTimeScheduler::SimTimeScheduler(physics::WorldPtr world)
+: world_(world), next_seq_(0), executing_owner_(nullptr)
+{
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&SimTimeScheduler::on_update, this, _1));
+}
+
+SimTimeScheduler::~SimTimeScheduler()
+{
+	update_connection_.reset();
+}
+
+/** Run a callback once the simulation time is reached.
+ * @param sim_time the simulation time in seconds
+ * @param owner the object the callback belongs to, used for cancel()
+ * @param callback the callback to run
+ */
+void
+SimTimeScheduler::schedule_at(double sim_time, const void *owner, Callback callback)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	tasks_.emplace(std::make_pair(sim_time, next_seq_++), Task{owner, std::move(callback)});
+}
+
+/** Drop all pending callbacks of an owner.
+ * If a callback of the owner is currently running, wait for it to finish, so
+ * the owner can safely be destroyed afterwards. If called from within a
+ * callback, the running callback is not waited for.
+ * @param owner the owner whose callbacks to drop
+ */
+void
+SimTimeScheduler::cancel(const void *owner)
+{
+	std::unique_lock<std::mutex> lock{mutex_};
+	for (auto it = tasks_.begin(); it != tasks_.end();) {
+		if (it->second.owner == owner) {
+			it = tasks_.erase(it);
+		} else {
+			++it;
+		}
+	}
+	if (executing_thread_ != std::this_thread::get_id()) {
+		executed_.wait(lock, [this, owner] { return executing_owner_ != owner; });
+	}
+}
+
+/** Get the current simulation time.
+ * @return the simulation time in seconds
+ */
+double
+SimTimeScheduler::now() const
+{
+	return world_->GZWRAP_SIM_TIME().Double();
+}
+
+void
+SimTimeScheduler::on_update(const common::UpdateInfo &info)
+{
+	const double                 time = info.simTime.Double();
+	std::unique_lock<std::mutex> lock{mutex_};
+	// Callbacks may schedule new tasks, so never iterate while running them.
+	while (!tasks_.empty() && tasks_.begin()->first.first <= time) {
+		Task task = std::move(tasks_.begin()->second);
+		tasks_.erase(tasks_.begin());
+		executing_owner_  = task.owner;
+		executing_thread_ = std::this_thread::get_id();
+		lock.unlock();
+		task.callback();
+		lock.lock();
+		executing_owner_  = nullptr;
+		executing_thread_ = std::thread::id();
+		executed_.notify_all();
+	}
+}
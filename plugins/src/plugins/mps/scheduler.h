@@ -0,0 +1,89 @@
+/***************************************************************************
+ *  scheduler.h - Run MPS continuations at a given simulation time
+ *
+ *  Created:   Sun 18 Oct 10:02:11 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace gazebo {
+
+/** Run callbacks once the simulation reaches a given time.
+ * There is one scheduler per world, shared by all stations of that world. It
+ * is driven by the WorldUpdateBegin event, so all callbacks are executed in
+ * the world update thread and their timing scales with the real time factor.
+ */
+class SimTimeScheduler
+{
+public:
+	typedef std::function<void()> Callback;
+
+	static std::shared_ptr<SimTimeScheduler> instance(physics::WorldPtr world);
+	~SimTimeScheduler();
+
+	/** Run a callback after the given amount of simulation time has passed.
+	 * @param delay simulation time to wait
+	 * @param owner the object the callback belongs to, used for cancel()
+	 * @param callback the callback to run
+	 */
+	template <class Rep, class Period>
+	void
+	schedule_in(const std::chrono::duration<Rep, Period> &delay, const void *owner, Callback callback)
+	{
+		schedule_at(now() + std::chrono::duration<double>(delay).count(), owner, std::move(callback));
+	}
+	void schedule_at(double sim_time, const void *owner, Callback callback);
+	void cancel(const void *owner);
+
+	double now() const;
+
+private:
+	explicit SimTimeScheduler(physics::WorldPtr world);
+	void on_update(const common::UpdateInfo &info);
+
+	struct Task
+	{
+		const void *owner;
+		Callback    callback;
+	};
+
+	physics::WorldPtr    world_;
+	event::ConnectionPtr update_connection_;
+
+	std::mutex              mutex_;
+	std::condition_variable executed_;
+	/// pending tasks, ordered by due time and insertion order
+	std::map<std::pair<double, uint64_t>, Task> tasks_;
+	uint64_t                                    next_seq_;
+	const void *                                executing_owner_;
+	std::thread::id                             executing_thread_;
+};
+
+} // namespace gazebo
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *  server_factory.cpp - Create the OPC UA servers of the stations
+ *
+ *  Created:   Sun 18 Oct 13:11:02 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "server_factory.h"
+
+#include <map>
+#include <mutex>
+
+using namespace gazebo;
+
+/** Start a server.
+ * @param endpoint the endpoint to listen on
+ * @param uri the URI of the server
+ * @return the running server, stopped once it is released
+ */
+static std::shared_ptr<OpcUa::UaServer>
+start(const std::string &endpoint, const std::string &uri)
+{
+	std::shared_ptr<OpcUa::UaServer> server(new OpcUa::UaServer(), [](OpcUa::UaServer *s) {
+		s->Stop();
+		delete s;
+	});
+	server->SetEndpoint(endpoint);
+	server->SetServerURI(uri);
+	server->Start();
+	return server;
+}
+
+/** Start a server for a single station.
+ * @param endpoint the endpoint to listen on
+ * @param uri the URI of the server
+ * @return the running server
+ */
+std::shared_ptr<OpcUa::UaServer>
+OpcUaServerFactory::dedicated(const std::string &endpoint, const std::string &uri)
+{
+	return start(endpoint, uri);
+}
+
+/** Get the shared server listening on an endpoint.
+ * The server is started on first use.
+ * @param endpoint the endpoint to listen on
+ * @return the running server
+ */
+std::shared_ptr<OpcUa::UaServer>
+OpcUaServerFactory::shared(const std::string &endpoint)
+{
+	static std::mutex                                             servers_mutex;
+	static std::map<std::string, std::weak_ptr<OpcUa::UaServer>> servers;
+
+	std::lock_guard<std::mutex>      lock{servers_mutex};
+	std::shared_ptr<OpcUa::UaServer> server = servers[endpoint].lock();
+	if (!server) {
+		server            = start(endpoint, "urn://ll.robocup.org/gazebo/shared");
+		servers[endpoint] = server;
+	}
+	return server;
+}
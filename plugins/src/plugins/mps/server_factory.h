@@ -0,0 +1,43 @@
+/***************************************************************************
+ *  server_factory.h - Create the OPC UA servers of the stations
+ *
+ *  Created:   Sun 18 Oct 13:11:02 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <opc/ua/server/server.h>
+
+#include <memory>
+#include <string>
+
+namespace gazebo {
+
+/** Factory for the OPC UA servers the stations run on.
+ * A dedicated server serves a single station on its own endpoint. A shared
+ * server is started once per endpoint and hosts every station that asks for
+ * it, each station under its own object below the Objects node. Servers are
+ * stopped when the last station using them is destroyed.
+ */
+class OpcUaServerFactory
+{
+public:
+	static std::shared_ptr<OpcUa::UaServer> dedicated(const std::string &endpoint,
+	                                                  const std::string &uri);
+	static std::shared_ptr<OpcUa::UaServer> shared(const std::string &endpoint);
+};
+
+} // namespace gazebo
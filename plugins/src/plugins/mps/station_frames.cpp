@@ -0,0 +1,188 @@
+/***************************************************************************
+ *  station_frames.cpp - Cached world frames of the stations
+ *
+ *  Created:   Sun 18 Oct 18:10:44 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "station_frames.h"
+
+#include <cmath>
+
+using namespace gazebo;
+
+/** Get the frame registry of a world.
+ * @param world the world to get the registry for
+ * @return the registry of the given world
+ */
+std::shared_ptr<StationFrameRegistry>
+StationFrameRegistry::instance(physics::WorldPtr world)
+{
+	static std::mutex                                                  instances_mutex;
+	static std::map<std::string, std::weak_ptr<StationFrameRegistry>> instances;
+
+	std::lock_guard<std::mutex>           lock{instances_mutex};
+	const std::string                     name     = world->GZWRAP_NAME();
+	std::shared_ptr<StationFrameRegistry> registry = instances[name].lock();
+	if (!registry) {
+		registry        = std::shared_ptr<StationFrameRegistry>(new StationFrameRegistry(world));
+		instances[name] = registry;
+	}
+	return registry;
+}
+
+StationFrameRegistry::StationFrameRegistry(physics::WorldPtr world) : world_(world)
+{
+	belt_offset_side_  = config->get_float("plugins/mps/belt_offset_side");
+	slide_offset_side_ = config->get_float("plugins/mps/slide_offset_side");
+	puck_size_         = config->get_float("plugins/mps/puck_size");
+	belt_length_       = config->get_float("plugins/mps/belt_length");
+	belt_height_       = config->get_float("plugins/mps/belt_height");
+}
+
+/** Get the frames of a station.
+ * The frames are computed on first use and whenever the station was moved.
+ * @param station the model of the station
+ * @return the frames of the station
+ */
+std::shared_ptr<const StationFrames>
+StationFrameRegistry::frames(const physics::ModelPtr &station)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	return lookup(station);
+}
+
+/** Get the frames of a station by its name.
+ * The model of the station is only looked up in the world once.
+ * @param station_name the name of the station, e.g. C-BS
+ * @return the frames of the station, nullptr if there is no such station
+ */
+std::shared_ptr<const StationFrames>
+StationFrameRegistry::frames(const std::string &station_name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	physics::ModelPtr           station;
+	auto                        entry = entries_.find(station_name);
+	if (entry != entries_.end()) {
+		station = entry->second.model.lock();
+	}
+	if (!station) {
+		station = world_->GZWRAP_MODEL_BY_NAME(station_name);
+	}
+	if (!station) {
+		return nullptr;
+	}
+	return lookup(station);
+}
+
+std::shared_ptr<const StationFrames>
+StationFrameRegistry::lookup(const physics::ModelPtr &station)
+{
+	Entry &entry = entries_[station->GetName()];
+	if (!entry.frames || !entry.frames->have_light || !entry.frames->have_tags
+	    || entry.frames->station != station->GZWRAP_WORLD_POSE()) {
+		entry.model  = station;
+		entry.frames = compute(station);
+	}
+	return entry.frames;
+}
+
+/** Convert a position given relative to the belt to the world frame.
+ * @param frames the frames of the station
+ * @param long_side offset along the long side of the station
+ * @param short_side offset to the belt length along the short side
+ * @param height the height in the world frame
+ * @return the pose in the world frame
+ */
+gzwrap::Pose3d
+StationFrameRegistry::station_pose(const StationFrames &frames,
+                                   double               long_side,
+                                   double               short_side,
+                                   double               height) const
+{
+	gzwrap::Pose3d pose = belt_pose(frames, long_side, (belt_length_ + short_side) / 2 - puck_size_);
+	return gzwrap::Pose3d(pose.GZWRAP_POS_X, pose.GZWRAP_POS_Y, height, 0, 0, 0);
+}
+
+gzwrap::Pose3d
+StationFrameRegistry::belt_pose(const StationFrames &frames, double long_side, double along) const
+{
+	const gzwrap::Pose3d &s = frames.station;
+	return gzwrap::Pose3d(s.GZWRAP_POS_X + (belt_offset_side_ + long_side) * frames.cos_yaw
+	                        - along * frames.sin_yaw,
+	                      s.GZWRAP_POS_Y + (belt_offset_side_ + long_side) * frames.sin_yaw
+	                        + along * frames.cos_yaw,
+	                      belt_height_,
+	                      0,
+	                      0,
+	                      0);
+}
+
+std::shared_ptr<const StationFrames>
+StationFrameRegistry::compute(const physics::ModelPtr &station) const
+{
+	std::shared_ptr<StationFrames> f(new StationFrames());
+	f->station = station->GZWRAP_WORLD_POSE();
+	f->sin_yaw = sin(f->station.GZWRAP_ROT_YAW);
+	f->cos_yaw = cos(f->station.GZWRAP_ROT_YAW);
+
+	//        z up
+	//       /
+	//      x---> I=====O <--- x
+	//      |                  |
+	//      y                  y
+	const gzwrap::Quaterniond yaw_correction(0, 0, IGN_PI_2);
+	const double              half_belt = belt_length_ / 2 - puck_size_;
+
+	f->input = belt_pose(*f, 0, half_belt);
+	f->input.Set(f->input.GZWRAP_POS, f->station.GZWRAP_ROT_SUB(yaw_correction));
+	f->output = belt_pose(*f, 0, -half_belt);
+	f->output.Set(f->output.GZWRAP_POS, f->station.GZWRAP_ROT_ADD(yaw_correction));
+	f->middle = belt_pose(*f, 0, 0);
+	f->middle.Set(f->middle.GZWRAP_POS, f->station.GZWRAP_ROT);
+	f->slide = belt_pose(*f, slide_offset_side_, half_belt);
+	f->slide.Set(f->slide.GZWRAP_POS, f->station.GZWRAP_ROT_SUB(yaw_correction));
+	for (unsigned int i = 0; i < f->shelf.size(); i++) {
+		f->shelf[i] = station_pose(*f, -0.1 * (i + 1), 0, belt_height_ + 0.005);
+	}
+
+	// the light signals are a nested model, so look the links up by their scoped name
+	const std::string prefix   = station->GetName() + "::";
+	const bool        have_in  = link_pose(prefix + "mps_tag_input", f->tag_input);
+	const bool        have_out = link_pose(prefix + "mps_tag_output", f->tag_output);
+	f->have_light              = link_pose(prefix + "light_signals::link", f->light);
+	f->have_tags               = have_in && have_out;
+	return f;
+}
+
+/** Get the world pose of a link.
+ * @param scoped_name the scoped name of the link, including its models
+ * @param pose set to the link's pose if it was found
+ * @return true if the link was found
+ */
+bool
+StationFrameRegistry::link_pose(const std::string &scoped_name, gzwrap::Pose3d &pose) const
+{
+	physics::EntityPtr link = world_->GZWRAP_ENTITY_BY_NAME(scoped_name);
+	if (!link) {
+		if (missing_links_.insert(scoped_name).second) {
+			printf("StationFrameRegistry: cannot find link %s\n", scoped_name.c_str());
+		}
+		return false;
+	}
+	missing_links_.erase(scoped_name);
+	pose = link->GZWRAP_WORLD_POSE();
+	return true;
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ *  station_frames.h - Cached world frames of the stations
+ *
+ *  Created:   Sun 18 Oct 18:10:44 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <configurable/configurable.h>
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <array>
+#include <boost/weak_ptr.hpp>
+#include <gazebo/physics/physics.hh>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace gazebo {
+
+/** Frames of a station in world coordinates.
+ * The conveyor and slide frames have their x axis pointing towards the middle
+ * of the conveyor, all other frames are aligned with the station.
+ */
+struct StationFrames
+{
+	/// pose of the station the frames were computed for
+	gzwrap::Pose3d station;
+	/// sine and cosine of the station's yaw
+	double sin_yaw, cos_yaw;
+
+	gzwrap::Pose3d input;
+	gzwrap::Pose3d output;
+	gzwrap::Pose3d middle;
+	/// slide of a ring station
+	gzwrap::Pose3d slide;
+	/// left, middle and right shelf slot of a cap station
+	std::array<gzwrap::Pose3d, 3> shelf;
+	/// link holding the light signals, only valid if have_light is set
+	gzwrap::Pose3d light;
+	bool           have_light;
+	/// links the input and output tags are mounted to, only valid if have_tags is set
+	gzwrap::Pose3d tag_input;
+	gzwrap::Pose3d tag_output;
+	bool           have_tags;
+};
+
+/** Registry of the frames of all stations of a world.
+ * Computing a frame needs the station's world pose and some trigonometry.
+ * Since stations do not move during a game, the frames are computed once and
+ * only recomputed if the pose of the station changes. Frames missing the light
+ * or tag links are recomputed on every lookup until the links are found,
+ * e.g. once the nested light signal model is inserted.
+ */
+class StationFrameRegistry : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	static std::shared_ptr<StationFrameRegistry> instance(physics::WorldPtr world);
+
+	std::shared_ptr<const StationFrames> frames(const physics::ModelPtr &station);
+	std::shared_ptr<const StationFrames> frames(const std::string &station_name);
+	gzwrap::Pose3d                       station_pose(const StationFrames &frames,
+	                                                  double               long_side,
+	                                                  double               short_side,
+	                                                  double               height) const;
+
+private:
+	explicit StationFrameRegistry(physics::WorldPtr world);
+	std::shared_ptr<const StationFrames> lookup(const physics::ModelPtr &station);
+	std::shared_ptr<const StationFrames> compute(const physics::ModelPtr &station) const;
+	gzwrap::Pose3d belt_pose(const StationFrames &frames, double long_side, double along) const;
+	bool           link_pose(const std::string &scoped_name, gzwrap::Pose3d &pose) const;
+
+	float belt_offset_side_;
+	float slide_offset_side_;
+	float puck_size_;
+	float belt_length_;
+	float belt_height_;
+
+	struct Entry
+	{
+		boost::weak_ptr<physics::Model>      model;
+		std::shared_ptr<const StationFrames> frames;
+	};
+
+	physics::WorldPtr             world_;
+	std::mutex                    mutex_;
+	std::map<std::string, Entry>  entries_;
+	/// links reported missing, so a retried lookup is only logged once
+	mutable std::set<std::string> missing_links_;
+};
+
+} // namespace gazebo
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *  station_logger.cpp - Create the loggers of the stations
+ *
+ *  Created:   Sun 18 Oct 15:21:45 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "station_logger.h"
+
+#include <spdlog/async_logger.h>
+#include <spdlog/details/thread_pool.h>
+#include <spdlog/sinks/basic_file_sink.h>
+
+#include <algorithm>
+
+using namespace gazebo;
+
+/** Constructor.
+ * @param sinks the sinks to pass the messages on to
+ * @param messages_per_second the number of debug and info messages to pass
+ * per second and the size of a burst, 0 to disable the limit
+ */
+RateLimitedSink::RateLimitedSink(std::vector<spdlog::sink_ptr> sinks,
+                                 unsigned int                  messages_per_second)
+: spdlog::sinks::dist_sink_mt(std::move(sinks)),
+  rate_(messages_per_second),
+  tokens_(messages_per_second),
+  last_(std::chrono::steady_clock::now())
+{
+}
+
+void
+RateLimitedSink::sink_it_(const spdlog::details::log_msg &msg)
+{
+	if (msg.level < spdlog::level::warn && !take_token()) {
+		return;
+	}
+	spdlog::sinks::dist_sink_mt::sink_it_(msg);
+}
+
+/** Take a token of the bucket, called with the sink's mutex held.
+ * @return true if the message may pass
+ */
+bool
+RateLimitedSink::take_token()
+{
+	if (rate_ == 0) {
+		return true;
+	}
+	auto   now     = std::chrono::steady_clock::now();
+	double elapsed = std::chrono::duration<double>(now - last_).count();
+	tokens_        = std::min<double>(rate_, tokens_ + rate_ * elapsed);
+	last_          = now;
+	if (tokens_ < 1.) {
+		return false;
+	}
+	tokens_ -= 1.;
+	return true;
+}
+
+/** Get the thread pool shared by all asynchronous station loggers.
+ * The pool has a single thread writing the messages of all stations.
+ * @param queue_size the number of messages the pool can hold, only used when
+ * the pool is created
+ * @return the thread pool
+ */
+static std::shared_ptr<spdlog::details::thread_pool>
+shared_thread_pool(size_t queue_size)
+{
+	static std::mutex                                    pool_mutex;
+	static std::shared_ptr<spdlog::details::thread_pool> pool;
+
+	std::lock_guard<std::mutex> lock{pool_mutex};
+	if (!pool) {
+		pool = std::make_shared<spdlog::details::thread_pool>(queue_size, 1);
+		// async loggers do not flush on every info message, so flush them regularly
+		spdlog::flush_every(std::chrono::seconds(1));
+	}
+	return pool;
+}
+
+/** Create the logger of a station.
+ * The logger writes to the sinks of the default logger and to the file
+ * gazebo-<name>.log. In asynchronous mode, messages are passed to a thread
+ * shared by all stations, which formats and writes them. If its queue is
+ * full, the logging thread either blocks or the oldest message is dropped.
+ * @param name the name of the station
+ * @param config the configuration to read the logging settings from
+ * @return the logger
+ */
+std::shared_ptr<spdlog::logger>
+gazebo::create_station_logger(const std::string &name, gazebo_rcll::Configuration *config)
+{
+	auto sinks = spdlog::default_logger()->sinks();
+	sinks.push_back(
+	  std::make_shared<spdlog::sinks::basic_file_sink_mt>(fmt::format("gazebo-{}.log", name), true));
+	spdlog::sink_ptr sink =
+	  std::make_shared<RateLimitedSink>(sinks, config->get_uint("plugins/mps/logging/rate_limit"));
+
+	std::shared_ptr<spdlog::logger> logger;
+	if (config->get_bool("plugins/mps/logging/async")) {
+		auto pool   = shared_thread_pool(config->get_uint("plugins/mps/logging/queue_size"));
+		auto policy = config->get_string("plugins/mps/logging/overflow") == "drop"
+		                ? spdlog::async_overflow_policy::overrun_oldest
+		                : spdlog::async_overflow_policy::block;
+		auto async_logger = std::make_shared<spdlog::async_logger>(name, sink, pool, policy);
+		async_logger->flush_on(spdlog::level::err);
+		logger = async_logger;
+		// register the logger, so it is flushed periodically
+		spdlog::drop(name);
+		spdlog::register_logger(logger);
+	} else {
+		auto sync_logger = std::make_shared<spdlog::logger>(name, sink);
+		sync_logger->flush_on(spdlog::level::info);
+		logger = sync_logger;
+	}
+	logger->set_pattern("[%c] [%^%l%$] [%n]: %v (%s:%# [%!])");
+	logger->set_level(spdlog::level::debug);
+	return logger;
+}
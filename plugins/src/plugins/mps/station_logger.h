@@ -0,0 +1,62 @@
+/***************************************************************************
+ *  station_logger.h - Create the loggers of the stations
+ *
+ *  Created:   Sun 18 Oct 15:21:45 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <config/config.h>
+#include <spdlog/sinks/dist_sink.h>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gazebo {
+
+/** Sink which passes messages on to other sinks up to a given rate.
+ * Warnings and errors are never dropped. spdlog's async_logger cannot be
+ * derived from, so the limit is applied by the sink all sinks of a station
+ * logger are wrapped in. With an asynchronous logger, the sink runs on the
+ * logging thread, so dropped messages still pass the logger's queue, whose
+ * size and overflow policy bound it. They are neither formatted by the
+ * pattern nor written, though.
+ */
+class RateLimitedSink : public spdlog::sinks::dist_sink_mt
+{
+public:
+	RateLimitedSink(std::vector<spdlog::sink_ptr> sinks, unsigned int messages_per_second);
+
+protected:
+	void sink_it_(const spdlog::details::log_msg &msg) override;
+
+private:
+	bool take_token();
+
+	/// messages per second and size of a burst, 0 for no limit
+	const unsigned int                    rate_;
+	double                                tokens_;
+	std::chrono::steady_clock::time_point last_;
+};
+
+std::shared_ptr<spdlog::logger> create_station_logger(const std::string &         name,
+                                                      gazebo_rcll::Configuration *config);
+
+} // namespace gazebo
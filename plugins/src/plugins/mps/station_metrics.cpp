@@ -0,0 +1,290 @@
+/***************************************************************************
+ *  station_metrics.cpp - Command counters and latency histograms of an MPS
+ *
+ *  Created:   Sun 18 Oct 14:40:18 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "station_metrics.h"
+
+#include <opc/ua/protocol/variant.h>
+#include <spdlog/fmt/fmt.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace gazebo;
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_(0.), max_(0.)
+{
+	buckets_.fill(0);
+}
+
+/** Add a duration.
+ * @param ms the duration in milliseconds
+ */
+void
+LatencyHistogram::record(double ms)
+{
+	ms            = std::max(0., ms);
+	size_t bucket = 0;
+	while (bucket < buckets_.size() - 1 && ms >= std::ldexp(1., bucket)) {
+		bucket++;
+	}
+	buckets_[bucket]++;
+	count_++;
+	sum_ += ms;
+	max_ = std::max(max_, ms);
+}
+
+uint32_t
+LatencyHistogram::count() const
+{
+	return count_;
+}
+
+double
+LatencyHistogram::mean() const
+{
+	return count_ > 0 ? sum_ / count_ : 0.;
+}
+
+double
+LatencyHistogram::max() const
+{
+	return max_;
+}
+
+/** Estimate a percentile from the buckets.
+ * @param p the percentile in the range [0, 1]
+ * @return the upper bound of the bucket containing the percentile, at most
+ * the maximum recorded duration
+ */
+double
+LatencyHistogram::percentile(double p) const
+{
+	if (count_ == 0) {
+		return 0.;
+	}
+	uint32_t rank = std::max<uint32_t>(1, std::ceil(p * count_));
+	uint32_t seen = 0;
+	for (size_t i = 0; i < buckets_.size(); i++) {
+		seen += buckets_[i];
+		if (seen >= rank) {
+			return std::min(max_, std::ldexp(1., i));
+		}
+	}
+	return max_;
+}
+
+std::string
+LatencyHistogram::to_json() const
+{
+	std::string buckets;
+	for (size_t i = 0; i < buckets_.size(); i++) {
+		buckets += fmt::format("{}{}", i > 0 ? "," : "", buckets_[i]);
+	}
+	return fmt::format("{{\"count\":{},\"mean\":{:.3f},\"p50\":{:.3f},\"p95\":{:.3f},"
+	                   "\"max\":{:.3f},\"buckets\":[{}]}}",
+	                   count_,
+	                   mean(),
+	                   percentile(0.5),
+	                   percentile(0.95),
+	                   max_,
+	                   buckets);
+}
+
+StationMetrics::StationMetrics()
+: commands_(0),
+  rejected_(0),
+  invalid_(0),
+  dropped_(0),
+  running_(false),
+  awaiting_idle_(false),
+  running_operation_(0),
+  running_since_(0.),
+  running_queue_wait_ms_(0.),
+  attached_(false)
+{
+}
+
+/** Start timing a command.
+ * The command is not counted yet, it may still be rejected or invalid.
+ * @param operation the operation of the command
+ * @param queue_wait_ms the wall-clock time the command spent in the queue
+ * @param sim_time the current simulation time
+ */
+void
+StationMetrics::command_started(uint16_t operation, double queue_wait_ms, double sim_time)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (running_) {
+		// the previous command never reported to be done
+		finish(sim_time);
+	}
+	running_               = true;
+	awaiting_idle_         = false;
+	running_operation_     = operation;
+	running_since_         = sim_time;
+	running_queue_wait_ms_ = queue_wait_ms;
+}
+
+/** Mark the command as processed by the station and count it.
+ * @param busy true if the station is busy with the command, it is then done
+ * as soon as poll() sees the station idle
+ * @param sim_time the current simulation time
+ */
+void
+StationMetrics::command_processed(bool busy, double sim_time)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (!running_) {
+		// rejected or invalid
+		return;
+	}
+	OperationMetrics &op = operations_[running_operation_];
+	op.count++;
+	op.queue_wait.record(running_queue_wait_ms_);
+	queue_wait_.record(running_queue_wait_ms_);
+	commands_++;
+	if (busy) {
+		awaiting_idle_ = true;
+	} else {
+		finish(sim_time);
+	}
+}
+
+/** Check whether a busy command is done.
+ * @param busy true if the station is still busy
+ * @param sim_time the current simulation time
+ */
+void
+StationMetrics::poll(bool busy, double sim_time)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (running_ && awaiting_idle_ && !busy) {
+		finish(sim_time);
+	}
+}
+
+void
+StationMetrics::finish(double sim_time)
+{
+	double ms = (sim_time - running_since_) * 1000.;
+	operations_[running_operation_].execution.record(ms);
+	execution_.record(ms);
+	running_       = false;
+	awaiting_idle_ = false;
+}
+
+/** Count the running command as meant for a different station.
+ * Rejected commands are not timed.
+ */
+void
+StationMetrics::command_rejected()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	rejected_++;
+	running_ = false;
+}
+
+/** Count the running command as having an invalid action id.
+ * Invalid commands are not timed.
+ */
+void
+StationMetrics::command_invalid()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	invalid_++;
+	running_ = false;
+}
+
+/** Count a command dropped because the command queue was full. */
+void
+StationMetrics::command_dropped()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	dropped_++;
+}
+
+/** Create the variables the metrics are published to.
+ * @param stats the object to create the variables in
+ */
+void
+StationMetrics::attach(OpcUa::Node stats)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	commands_node_        = stats.AddVariable(4, "Commands", OpcUa::Variant((uint32_t)0));
+	rejected_node_        = stats.AddVariable(4, "Rejected", OpcUa::Variant((uint32_t)0));
+	invalid_node_         = stats.AddVariable(4, "Invalid", OpcUa::Variant((uint32_t)0));
+	dropped_node_         = stats.AddVariable(4, "Dropped", OpcUa::Variant((uint32_t)0));
+	queue_wait_mean_node_ = stats.AddVariable(4, "QueueWaitMeanMs", OpcUa::Variant(0.));
+	queue_wait_max_node_  = stats.AddVariable(4, "QueueWaitMaxMs", OpcUa::Variant(0.));
+	execution_mean_node_  = stats.AddVariable(4, "ExecutionMeanMs", OpcUa::Variant(0.));
+	execution_max_node_   = stats.AddVariable(4, "ExecutionMaxMs", OpcUa::Variant(0.));
+	execution_p95_node_   = stats.AddVariable(4, "ExecutionP95Ms", OpcUa::Variant(0.));
+	attached_             = true;
+}
+
+/** Write the current metrics to the OPC UA variables. */
+void
+StationMetrics::publish()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (!attached_) {
+		return;
+	}
+	commands_node_.SetValue(OpcUa::Variant(commands_));
+	rejected_node_.SetValue(OpcUa::Variant(rejected_));
+	invalid_node_.SetValue(OpcUa::Variant(invalid_));
+	dropped_node_.SetValue(OpcUa::Variant(dropped_));
+	queue_wait_mean_node_.SetValue(OpcUa::Variant(queue_wait_.mean()));
+	queue_wait_max_node_.SetValue(OpcUa::Variant(queue_wait_.max()));
+	execution_mean_node_.SetValue(OpcUa::Variant(execution_.mean()));
+	execution_max_node_.SetValue(OpcUa::Variant(execution_.max()));
+	execution_p95_node_.SetValue(OpcUa::Variant(execution_.percentile(0.95)));
+}
+
+/** Serialize the metrics as a single line of JSON.
+ * @param station the name of the station
+ * @param sim_time the current simulation time
+ * @return the metrics as JSON object
+ */
+std::string
+StationMetrics::to_json(const std::string &station, double sim_time)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	std::string                 operations;
+	for (const auto &op : operations_) {
+		operations += fmt::format("{}\"{}\":{{\"count\":{},\"queue_wait_ms\":{},\"execution_ms\":{}}}",
+		                          operations.empty() ? "" : ",",
+		                          op.first,
+		                          op.second.count,
+		                          op.second.queue_wait.to_json(),
+		                          op.second.execution.to_json());
+	}
+	return fmt::format("{{\"station\":\"{}\",\"sim_time\":{:.3f},\"commands\":{},\"rejected\":{},"
+	                   "\"invalid\":{},\"dropped\":{},\"queue_wait_ms\":{},\"execution_ms\":{},"
+	                   "\"operations\":{{{}}}}}",
+	                   station,
+	                   sim_time,
+	                   commands_,
+	                   rejected_,
+	                   invalid_,
+	                   dropped_,
+	                   queue_wait_.to_json(),
+	                   execution_.to_json(),
+	                   operations);
+}
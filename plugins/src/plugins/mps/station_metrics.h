@@ -0,0 +1,118 @@
+/***************************************************************************
+ *  station_metrics.h - Command counters and latency histograms of an MPS
+ *
+ *  Created:   Sun 18 Oct 14:40:18 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <opc/ua/node.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace gazebo {
+
+/** Histogram of durations in milliseconds with power-of-two buckets. */
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void     record(double ms);
+	uint32_t count() const;
+	double   mean() const;
+	double   max() const;
+	double   percentile(double p) const;
+
+	std::string to_json() const;
+
+private:
+	/// bucket i holds durations below 2^i ms, the last one all larger ones
+	std::array<uint32_t, 20> buckets_;
+	uint32_t                 count_;
+	double                   sum_;
+	double                   max_;
+};
+
+/** Metrics of a single station.
+ * A command is timed from the moment it is taken from the queue until the
+ * station is no longer busy. It is only counted once the station processed
+ * it, commands rejected or found invalid meanwhile are neither counted nor
+ * timed. The time a command waited in the queue is
+ * measured in wall-clock time, as it only depends on the host, while the
+ * execution time is measured in simulation time, like the operations
+ * themselves.
+ * All methods are thread-safe.
+ */
+class StationMetrics
+{
+public:
+	StationMetrics();
+
+	void command_started(uint16_t operation, double queue_wait_ms, double sim_time);
+	void command_processed(bool busy, double sim_time);
+	void poll(bool busy, double sim_time);
+	void command_rejected();
+	void command_invalid();
+	void command_dropped();
+
+	void        attach(OpcUa::Node stats);
+	void        publish();
+	std::string to_json(const std::string &station, double sim_time);
+
+private:
+	void finish(double sim_time);
+
+	struct OperationMetrics
+	{
+		uint32_t         count = 0;
+		LatencyHistogram queue_wait;
+		LatencyHistogram execution;
+	};
+
+	std::mutex                           mutex_;
+	std::map<uint16_t, OperationMetrics> operations_;
+	LatencyHistogram                     queue_wait_;
+	LatencyHistogram                     execution_;
+	uint32_t                             commands_;
+	uint32_t                             rejected_;
+	uint32_t                             invalid_;
+	uint32_t                             dropped_;
+
+	/// the command currently executed, if any
+	bool     running_;
+	bool     awaiting_idle_;
+	uint16_t running_operation_;
+	double   running_since_;
+	double   running_queue_wait_ms_;
+
+	bool        attached_;
+	OpcUa::Node commands_node_;
+	OpcUa::Node rejected_node_;
+	OpcUa::Node invalid_node_;
+	OpcUa::Node dropped_node_;
+	OpcUa::Node queue_wait_mean_node_;
+	OpcUa::Node queue_wait_max_node_;
+	OpcUa::Node execution_mean_node_;
+	OpcUa::Node execution_max_node_;
+	OpcUa::Node execution_p95_node_;
+};
+
+} // namespace gazebo
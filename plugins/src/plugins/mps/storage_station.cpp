@@ -27,23 +27,19 @@ using namespace gazebo;
 StorageStation::StorageStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf) : Mps(_parent, _sdf)
 {
 	station_ = Station::STATION_STORAGE;
-	start_server();
 	storage_ = new Storage[STORAGE_SIZE];
 
 	//EMPTY all storage slots
 	for (int i = 0; i < STORAGE_SIZE; i++) {
-		storage_[i].puck_name = "";
-		storage_[i].has_puck  = false;
+		storage_[i].has_puck = false;
 	}
 
-	pucks_spawned = false;
-
 	storage_cnt = 0;
 
 	shelf_pos_x = SHELF_POS_X;
 	shelf_pos_z = SHELF_POS_Z;
 
-	if (name_.find("M-") != std::string::npos) {
+	if (llsf_utils::machine_info(machine_id_).team == llsf_utils::MachineTeam::MAGENTA) {
 		shelf_pos_y = 0.0;
 		printf("Strage_Station: Generating Puck Storage Magenta\n");
 	} else {
@@ -67,32 +63,8 @@ StorageStation::~StorageStation()
 }
 
 void
-StorageStation::process_command_in()
-{
-}
-
-void
-StorageStation::OnUpdate(const common::UpdateInfo &info)
+StorageStation::process_command_in(const MpsCommand &)
 {
-	Mps::OnUpdate(info);
-	if (model_->GetWorld()->GZWRAP_SIM_TIME().Double() - created_time_ > 10 && !pucks_spawned) {
-		printf("%s: Start Spawning Pucks\n", name_.c_str());
-
-		for (uint i = 0; i < STORAGE_SIZE; i++) {
-			if (storage_[i].has_puck) {
-				Storage     slot = storage_[i];
-				std::string puck_name =
-				  spawn_puck(get_slot_World_position(slot.slot_x, slot.slot_y, slot.slot_z), slot.base_clr);
-
-				if (puck_name == "") {
-					printf("%s: ERROR SPAWN of STORAGE PUCK FAILED\n", name_.c_str());
-					continue;
-				}
-				storage_[i].puck_name = puck_name;
-			}
-		}
-		pucks_spawned = true;
-	}
 }
 
 void
@@ -112,16 +84,17 @@ StorageStation::init_storage()
 		int z     = (int)slotpos.at(2) - '0';
 		int index = getStorageIndex(x, y, z);
 
-		storage_[index].slot_x = x;
-		storage_[index].slot_y = y;
-		storage_[index].slot_z = z;
+		storage_[index].slot_x              = x;
+		storage_[index].slot_y              = y;
+		storage_[index].slot_z              = z;
+		storage_[index].workpiece.cap_color = gazsim_msgs::Color::NONE;
 
 		if (puck_cfg.at(0) == "BLACK") {
-			storage_[index].base_clr = gazsim_msgs::Color::BLACK;
+			storage_[index].workpiece.base_color = gazsim_msgs::Color::BLACK;
 		} else if (puck_cfg.at(0) == "SILVER") {
-			storage_[index].base_clr = gazsim_msgs::Color::SILVER;
+			storage_[index].workpiece.base_color = gazsim_msgs::Color::SILVER;
 		} else if (puck_cfg.at(0) == "RED") {
-			storage_[index].base_clr = gazsim_msgs::Color::RED;
+			storage_[index].workpiece.base_color = gazsim_msgs::Color::RED;
 		} else
 			printf("%s: unknown base color %s at slot%s \n",
 			       name_.c_str(),
@@ -133,13 +106,13 @@ StorageStation::init_storage()
 			//add Rings to puck
 			for (int j = 1; j < last; j++) {
 				if (puck_cfg.at(j) == "YELLOW") {
-					storage_[index].ring_colors.push_back(gazsim_msgs::Color::YELLOW);
+					storage_[index].workpiece.ring_colors.push_back(gazsim_msgs::Color::YELLOW);
 				} else if (puck_cfg.at(j) == "ORANGE") {
-					storage_[index].ring_colors.push_back(gazsim_msgs::Color::ORANGE);
+					storage_[index].workpiece.ring_colors.push_back(gazsim_msgs::Color::ORANGE);
 				} else if (puck_cfg.at(j) == "GREEN") {
-					storage_[index].ring_colors.push_back(gazsim_msgs::Color::GREEN);
+					storage_[index].workpiece.ring_colors.push_back(gazsim_msgs::Color::GREEN);
 				} else if (puck_cfg.at(j) == "BLUE") {
-					storage_[index].ring_colors.push_back(gazsim_msgs::Color::BLUE);
+					storage_[index].workpiece.ring_colors.push_back(gazsim_msgs::Color::BLUE);
 				} else
 					printf("%s: ERROR unknown ring color %s at slot%s \n",
 					       name_.c_str(),
@@ -149,11 +122,11 @@ StorageStation::init_storage()
 		}
 
 		if (puck_cfg.at(last) == "BLACK") {
-			storage_[index].cap_clr = gazsim_msgs::Color::BLACK;
+			storage_[index].workpiece.cap_color = gazsim_msgs::Color::BLACK;
 		} else if (puck_cfg.at(last) == "GRAY") {
-			storage_[index].cap_clr = gazsim_msgs::Color::GREY;
+			storage_[index].workpiece.cap_color = gazsim_msgs::Color::GREY;
 		} else if (puck_cfg.at(last) == "") {
-			storage_[index].cap_clr = gazsim_msgs::Color::NONE;
+			storage_[index].workpiece.cap_color = gazsim_msgs::Color::NONE;
 		} else
 			printf("%s: ERROR unknown cap color %s at slot%s \n",
 			       name_.c_str(),
@@ -161,13 +134,15 @@ StorageStation::init_storage()
 			       slotpos.c_str());
 
 		storage_[index].has_puck = true;
+		storage_cnt++;
 	}
 }
 
 void
-StorageStation::on_puck_msg(ConstPosePtr &msg)
+StorageStation::on_workpiece_event(StationZone zone, const WorkpieceEvent &event)
 {
-	if (msg->name() == puck_on_conveyor && !puck_in_input(msg)) {
+	if (zone == StationZone::INPUT && event.type == WorkpieceEvent::LEFT
+	    && event.name == puck_on_conveyor) {
 		puck_on_conveyor = "";
 		//set_state(State::RETRIEVED);
 	}
@@ -247,53 +222,24 @@ StorageStation::on_puck_msg(ConstPosePtr &msg)
 //	}
 //}
 
+/** Store a workpiece in a slot.
+ * Only the workpiece's data is kept, the caller takes its model out of the
+ * simulation, e.g. with dematerialize().
+ */
 void
-StorageStation::on_new_puck(ConstNewPuckPtr &msg)
-{
-	//if(puck_in_input(new_puck->GZWRAP_WORLD_POSE()) || puck_in_output(new_puck->GZWRAP_WORLD_POSE()))
-	//{
-
-	//    for (int z=0; z<SLOT_Z_COUNT;z++)
-	//        for (int y=0; y<SLOT_Y_COUNT; y++)
-	//            for (int x=0; x<SLOT_X_COUNT; x++){
-	//                if (pose_hit(new_puck->GZWRAP_WORLD_POSE(),get_slot_World_position(x,y,z),0.05)){
-
-	for (uint i = 0; i < STORAGE_SIZE; i++) {
-		if (storage_[i].puck_name == msg->puck_name()) {
-			Storage slot = storage_[i];
-			Mps::on_new_puck(msg);
-			physics::ModelPtr new_puck = world_->GZWRAP_MODEL_BY_NAME(msg->puck_name());
-
-			addRings(slot.puck_name, slot.ring_colors);
-			addCap(new_puck, slot.cap_clr);
-
-			store_puck(new_puck->GetName(), slot.slot_x, slot.slot_y, slot.slot_z);
-			return;
-		}
-	}
-	//}
-}
-
-void
-StorageStation::store_puck(std::string puck_name,
-                           uint32_t    slot_pos_x,
-                           uint32_t    slot_pos_y,
-                           uint32_t    slot_pos_z)
+StorageStation::store_puck(const VirtualWorkpiece &workpiece,
+                           uint32_t                slot_pos_x,
+                           uint32_t                slot_pos_y,
+                           uint32_t                slot_pos_z)
 {
 	int index = getStorageIndex(slot_pos_x, slot_pos_y, slot_pos_z);
 
-	if (storage_[index].puck_name == puck_name) {
-		// puck is already in Storage
-		return;
-	}
-
-	if (storage_[index].puck_name != "") {
-		printf("%s ERROR: SLOT %d,%d,%d not EMPTY stored puck %s\n",
+	if (storage_[index].has_puck) {
+		printf("%s ERROR: SLOT %d,%d,%d not EMPTY\n",
 		       name_.c_str(),
 		       slot_pos_x,
 		       slot_pos_y,
-		       slot_pos_z,
-		       storage_[index].puck_name.c_str());
+		       slot_pos_z);
 		return;
 	}
 
@@ -304,9 +250,16 @@ StorageStation::store_puck(std::string puck_name,
 	       slot_pos_y,
 	       slot_pos_z,
 	       ++storage_cnt);
-	storage_[index].puck_name = puck_name;
+	storage_[index].slot_x    = slot_pos_x;
+	storage_[index].slot_y    = slot_pos_y;
+	storage_[index].slot_z    = slot_pos_z;
+	storage_[index].has_puck  = true;
+	storage_[index].workpiece = workpiece;
 }
 
+/** Put the workpiece of a slot onto the input.
+ * The workpiece is materialized at the input, including its rings and cap.
+ */
 void
 StorageStation::retrieve_puck(uint32_t slot_pos_x, uint32_t slot_pos_y, uint32_t slot_pos_z)
 {
@@ -317,59 +270,36 @@ StorageStation::retrieve_puck(uint32_t slot_pos_x, uint32_t slot_pos_y, uint32_t
 	// X and Z is swapped to match message coords with gazebo coords
 	int index = getStorageIndex(slot_pos_x, slot_pos_y, slot_pos_z);
 
-	if (storage_[index].puck_name == "") {
+	if (!storage_[index].has_puck) {
 		printf("%s ERROR: SLOT %d,%d,%d EMPTY\n", name_.c_str(), slot_pos_x, slot_pos_y, slot_pos_z);
 		return;
 	}
 
-	printf("Retrieve PUCK %s FROM SLOT xyz %d,%d,%d\n",
-	       storage_[index].puck_name.c_str(),
+	gzwrap::Pose3d pose      = input();
+	std::string    puck_name = materialize(storage_[index].workpiece, pose);
+	if (puck_name.empty()) {
+		printf("%s: ERROR SPAWN of STORAGE PUCK FAILED\n", name_.c_str());
+		return;
+	}
+	printf("%s: Retrieve PUCK %s FROM SLOT xyz %d,%d,%d to input: %f,%f,%f\n",
+	       name_.c_str(),
+	       puck_name.c_str(),
 	       slot_pos_x,
 	       slot_pos_y,
-	       slot_pos_z);
-
-	gzwrap::Pose3d pose = input();
-	world_->GZWRAP_MODEL_BY_NAME(storage_[index].puck_name)->SetWorldPose(input());
-	printf("%s: Moving PUCK %s to input: %f,%f,%f",
-	       name_.c_str(),
-	       storage_[index].puck_name.c_str(),
+	       slot_pos_z,
 	       pose.GZWRAP_POS.GZWRAP_X,
 	       pose.GZWRAP_POS.GZWRAP_Y,
 	       pose.GZWRAP_POS.GZWRAP_Z);
 
-	puck_on_conveyor = storage_[index].puck_name;
+	puck_on_conveyor = puck_name;
 
-	storage_[index].puck_name = "";
-	storage_[index].has_puck  = false;
+	storage_[index].has_puck = false;
 	storage_cnt--;
 
 	//set_state(State::PROCESSED);
 	//set_state(State::DELIVERED);
 }
 
-void
-StorageStation::addCap(physics::ModelPtr puck, gazsim_msgs::Color clr)
-{
-	//ADD CAP TO PUCK
-	gazsim_msgs::WorkpieceCommand cmd;
-	cmd.set_command(gazsim_msgs::Command::ADD_CAP);
-	cmd.add_color(clr);
-	cmd.set_puck_name(puck->GetName());
-	puck_cmd_pub_->Publish(cmd);
-}
-// THIS IS STILL EXPERIMENTAL STUFF
-void
-StorageStation::addRings(std::string puck_name, std::vector<gazsim_msgs::Color> clr_list)
-{
-	for (uint i = 0; i < clr_list.size(); i++) {
-		gazsim_msgs::WorkpieceCommand cmd;
-		cmd.set_command(gazsim_msgs::Command::ADD_RING);
-		cmd.add_color(clr_list.at(i));
-		cmd.set_puck_name(puck_name);
-		puck_cmd_pub_->Publish(cmd);
-	}
-}
-
 gzwrap::Pose3d
 StorageStation::get_slot_World_position(uint32_t slot_x, uint32_t slot_y, uint32_t slot_z)
 {
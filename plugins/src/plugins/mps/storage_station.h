@@ -49,22 +49,18 @@ class StorageStation : public Mps
 public:
 	StorageStation(physics::ModelPtr _parent, sdf::ElementPtr _sdf);
 	~StorageStation();
-	void process_command_in();
+	void process_command_in(const MpsCommand &cmd);
 
 private:
-	void on_puck_msg(ConstPosePtr &msg);
-	void OnUpdate(const common::UpdateInfo &info);
-
-	void on_new_puck(ConstNewPuckPtr &msg);
+	void on_workpiece_event(StationZone zone, const WorkpieceEvent &event) override;
 
 	gzwrap::Pose3d get_slot_World_position(uint32_t slot_x, uint32_t slot_y, uint32_t slot_z);
 	void           init_storage();
-	void
-	store_puck(std::string puck_name, uint32_t slot_pos_x, uint32_t slot_pos_y, uint32_t slot_pos_z);
-	void retrieve_puck(uint32_t slot_pos_x, uint32_t slot_pos_y, uint32_t slot_pos_z);
-
-	void addCap(physics::ModelPtr puck, gazsim_msgs::Color clr);
-	void addRings(std::string puck_name, std::vector<gazsim_msgs::Color> clr_list);
+	void           store_puck(const VirtualWorkpiece &workpiece,
+	                          uint32_t                slot_pos_x,
+	                          uint32_t                slot_pos_y,
+	                          uint32_t                slot_pos_z);
+	void           retrieve_puck(uint32_t slot_pos_x, uint32_t slot_pos_y, uint32_t slot_pos_z);
 
 	int  getStorageIndex(int x, int y, int z);
 	int *to3D(int idx);
@@ -79,7 +75,6 @@ private:
 	double shelf_z_offset;
 
 	Storage *storage_;
-	bool     pucks_spawned;
 
 	//not really needed just for testing
 	int storage_cnt;
@@ -87,17 +82,15 @@ private:
 	std::string puck_on_conveyor;
 };
 
+/// A storage slot, the stored workpiece is only materialized when it is retrieved
 class Storage
 {
 public:
-	std::string                     puck_name;
-	int                             slot_x;
-	int                             slot_y;
-	int                             slot_z;
-	bool                            has_puck;
-	gazsim_msgs::Color              base_clr;
-	std::vector<gazsim_msgs::Color> ring_colors;
-	gazsim_msgs::Color              cap_clr;
+	int              slot_x;
+	int              slot_y;
+	int              slot_z;
+	bool             has_puck;
+	VirtualWorkpiece workpiece;
 };
 
 } // namespace gazebo
@@ -11,14 +11,17 @@ class Mps;
 class SubscriptionClient : public OpcUa::SubscriptionHandler
 {
 public:
-	SubscriptionClient(gazebo::Mps *station_,
-	                   void (gazebo::Mps::*callback_funk_)(void),
+	/// called with the monitored item handle and the delivered value
+	typedef void (gazebo::Mps::*Callback)(uint32_t handle, const OpcUa::Variant &value);
+
+	SubscriptionClient(gazebo::Mps *                  station_,
+	                   Callback                        callback_funk_,
 	                   std::shared_ptr<spdlog::logger> logger_)
 	: station(station_), callback_funk(callback_funk_), logger(logger_)
 	{
 	}
 
-	SubscriptionClient(gazebo::Mps *station_, void (gazebo::Mps::*callback_funk_)(void))
+	SubscriptionClient(gazebo::Mps *station_, Callback callback_funk_)
 	: SubscriptionClient(station_, callback_funk_, nullptr)
 	{
 	}
@@ -36,7 +39,7 @@ public:
 		//delete mpsValue;
 	}
 	void
-	set_callback_funk(void (gazebo::Mps::*callback_funk_)(void))
+	set_callback_funk(Callback callback_funk_)
 	{
 		callback_funk = callback_funk_;
 	}
@@ -48,8 +51,8 @@ public:
 	}
 
 protected:
-	gazebo::Mps *station;
-	void (gazebo::Mps::*callback_funk)(void);
+	gazebo::Mps *                   station;
+	Callback                        callback_funk;
 	std::shared_ptr<spdlog::logger> logger;
 
 	void
@@ -65,7 +68,7 @@ protected:
 		//	std::cout << "Received DataChange event for Node " << node << std::endl;
 		//	print_node_value(&node, val);
 		//}
-		(station->*callback_funk)();
+		(station->*callback_funk)(handle, val);
 	};
 	void
 	print_node_value(const OpcUa::Node *             n,
@@ -0,0 +1,280 @@
+/***************************************************************************
+ *  workpiece_pool.cpp - Recycle workpiece models instead of spawning new ones
+ *
+ *  Created:   Sun 18 Oct 22:17:25 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "workpiece_pool.h"
+
+#include <utils/misc/sdf_template.h>
+
+#include <boost/bind.hpp>
+#include <cstdlib>
+
+using namespace gazebo;
+
+/** Get the workpiece SDF precompiled for each base color.
+ * The model SDF is read and split once, spawning only fills in the name.
+ * @return the templates by base color, empty if the SDF cannot be read
+ */
+static const std::map<gazsim_msgs::Color, gazebo_rcll::SdfTemplate> &
+workpiece_templates()
+{
+	enum { NAME, COLOR, PLUGIN };
+	static const std::map<gazsim_msgs::Color, gazebo_rcll::SdfTemplate> templates = [] {
+		std::map<gazsim_msgs::Color, gazebo_rcll::SdfTemplate> variants;
+		std::shared_ptr<const std::string>                     sdf =
+		  gazebo_rcll::model_sdf("workpiece_base");
+		if (!sdf) {
+			return variants;
+		}
+		gazebo_rcll::SdfTemplate base(*sdf,
+		                              {{"workpiece_base", false},
+		                               {"1.0 0.35 0.0 1", true},
+		                               {"<plugin name=\"Puck\" filename=\"libpuck.so\"/>", false}});
+		if (!base.has_slot(NAME)) {
+			return variants;
+		}
+		const std::map<gazsim_msgs::Color, std::string> colors = {
+		  {gazsim_msgs::Color::RED, "1.0 0.0 0.0 1"},
+		  {gazsim_msgs::Color::BLACK, "0.2 0.2 0.2 1"},
+		  {gazsim_msgs::Color::SILVER, "0.8 0.8 0.8 1"}};
+		for (const auto &color : colors) {
+			variants[color.first] =
+			  base.bind(COLOR, color.second)
+			    .bind(PLUGIN,
+			          "<plugin name=\"Puck\" filename=\"libpuck.so\"><baseColor>"
+			            + gazsim_msgs::Color_Name(color.first) + "</baseColor></plugin>");
+		}
+		return variants;
+	}();
+	return templates;
+}
+
+/** Get the workpiece pool of a world.
+ * @param world the world to get the pool for
+ * @return the pool of the given world
+ */
+std::shared_ptr<WorkpiecePool>
+WorkpiecePool::instance(physics::WorldPtr world)
+{
+	static std::mutex                                           instances_mutex;
+	static std::map<std::string, std::weak_ptr<WorkpiecePool>> instances;
+
+	std::lock_guard<std::mutex>    lock{instances_mutex};
+	const std::string              name = world->GZWRAP_NAME();
+	std::shared_ptr<WorkpiecePool> pool = instances[name].lock();
+	if (!pool) {
+		pool            = std::shared_ptr<WorkpiecePool>(new WorkpiecePool(world));
+		instances[name] = pool;
+	}
+	return pool;
+}
+
+WorkpiecePool::WorkpiecePool(physics::WorldPtr world) : world_(world), spawned_(false)
+{
+	size_             = config->get_uint("plugins/mps/workpiece-pool/size");
+	parking_position_ = config->get_floats("plugins/mps/workpiece-pool/parking_position");
+	parking_spacing_  = config->get_float("plugins/mps/workpiece-pool/parking_spacing");
+	parking_position_.resize(3, 0.f);
+
+	node_ = transport::NodePtr(new transport::Node());
+	node_->Init(world_->GZWRAP_NAME());
+	factory_pub_  = node_->Advertise<msgs::Factory>("~/factory");
+	puck_cmd_pub_ = node_->Advertise<gazsim_msgs::WorkpieceCommand>(
+	  config->get_string("plugins/mps/topic_puck_command"));
+
+	for (std::size_t i = 0; i < size_; i++) {
+		std::string name = "puck_pool_" + std::to_string(i);
+		slots_.push_back(Slot{name, boost::weak_ptr<physics::Model>(), Slot::SPAWNING});
+		slot_by_name_[name] = i;
+	}
+	spawning_    = size_;
+	checked_out_ = 0;
+
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&WorkpiecePool::on_update, this));
+}
+
+WorkpiecePool::~WorkpiecePool()
+{
+	update_connection_.reset();
+}
+
+/** Get a workpiece at a pose.
+ * A parked workpiece is taken from the pool if there is one. With the next
+ * world update, it is moved to the pose, reset to a bare base of the given
+ * color and announced on ~/new_puck like a newly spawned workpiece.
+ * Otherwise, a new workpiece is spawned. This may be called from any thread.
+ * @param pose where to put the workpiece
+ * @param base_color the color of the workpiece's base
+ * @return the name of the workpiece, empty if it could not be spawned
+ */
+std::string
+WorkpiecePool::spawn(const gzwrap::Pose3d &pose, gazsim_msgs::Color base_color)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		for (Slot &slot : slots_) {
+			if (slot.state != Slot::PARKED || slot.model.expired()) {
+				continue;
+			}
+			slot.state      = Slot::CHECKED_OUT;
+			slot.pose       = pose;
+			slot.base_color = base_color;
+			checked_out_++;
+			return slot.name;
+		}
+	}
+	std::string name = "puck_" + std::to_string(rand() % 1000000);
+	return spawn_model(name, pose, base_color) ? name : "";
+}
+
+/** Return a workpiece to the pool, e.g. once it was delivered.
+ * Workpieces which were not spawned by the pool are adopted, so the number
+ * of workpieces stays bounded over a game. The workpiece is parked right
+ * away, so this must be called from the world update thread.
+ * @param workpiece the workpiece to park
+ */
+void
+WorkpiecePool::checkin(const physics::ModelPtr &workpiece)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        entry = slot_by_name_.find(workpiece->GetName());
+	std::size_t                 slot;
+	if (entry == slot_by_name_.end()) {
+		slot = slots_.size();
+		slots_.push_back(Slot{workpiece->GetName(), workpiece, Slot::IN_USE});
+		slot_by_name_[workpiece->GetName()] = slot;
+	} else {
+		slot = entry->second;
+		if (slots_[slot].state == Slot::PARKED) {
+			return;
+		}
+		if (slots_[slot].state == Slot::SPAWNING) {
+			spawning_--;
+		} else if (slots_[slot].state == Slot::CHECKED_OUT) {
+			checked_out_--;
+		}
+		slots_[slot].model = workpiece;
+	}
+	park(workpiece, slot);
+	slots_[slot].state = Slot::PARKED;
+}
+
+/** Spawn the pool once the factory is up and park the workpieces once they show up.
+ * Workpieces checked out since the last update are moved to their pose.
+ */
+void
+WorkpiecePool::on_update()
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (!spawned_) {
+		if (!factory_pub_->HasConnections()) {
+			return;
+		}
+		for (std::size_t i = 0; i < size_; i++) {
+			spawn_model(slots_[i].name, parking_pose(i), gazsim_msgs::Color::RED);
+		}
+		spawned_ = true;
+	}
+	for (std::size_t i = 0; spawning_ > 0 && i < slots_.size(); i++) {
+		if (slots_[i].state != Slot::SPAWNING) {
+			continue;
+		}
+		physics::ModelPtr model = world_->GZWRAP_MODEL_BY_NAME(slots_[i].name);
+		if (model) {
+			slots_[i].model = model;
+			slots_[i].state = Slot::PARKED;
+			park(model, i);
+			spawning_--;
+		}
+	}
+	for (std::size_t i = 0; checked_out_ > 0 && i < slots_.size(); i++) {
+		if (slots_[i].state != Slot::CHECKED_OUT) {
+			continue;
+		}
+		checked_out_--;
+		slots_[i].state         = Slot::IN_USE;
+		physics::ModelPtr model = slots_[i].model.lock();
+		if (!model) {
+			// the parked model was removed meanwhile, spawn it anew under the promised name
+			spawn_model(slots_[i].name, slots_[i].pose, slots_[i].base_color);
+			continue;
+		}
+		model->SetWorldPose(slots_[i].pose);
+		model->ResetPhysicsStates();
+		model->SetEnabled(true);
+		gazsim_msgs::WorkpieceCommand cmd;
+		cmd.set_command(gazsim_msgs::Command::RESET);
+		cmd.add_color(slots_[i].base_color);
+		cmd.set_puck_name(slots_[i].name);
+		puck_cmd_pub_->Publish(cmd);
+	}
+}
+
+bool
+WorkpiecePool::spawn_model(const std::string &   name,
+                           const gzwrap::Pose3d &pose,
+                           gazsim_msgs::Color    base_color)
+{
+	const std::map<gazsim_msgs::Color, gazebo_rcll::SdfTemplate> &templates = workpiece_templates();
+	if (templates.empty()) {
+		printf("Cant find workpiece_base sdf file\n");
+		return false;
+	}
+	auto sdf_template = templates.find(base_color);
+	if (sdf_template == templates.end()) {
+		printf("%s should spawn with an unsupported base color %s\n",
+		       name.c_str(),
+		       gazsim_msgs::Color_Name(base_color).c_str());
+		return false;
+	}
+	// spawn() may be called from any thread
+	thread_local std::string sdf;
+	sdf_template->second.render({name}, sdf);
+
+	msgs::Factory factory_msg;
+	factory_msg.set_sdf(sdf);
+	factory_msg.set_clone_model_name(name);
+#if GAZEBO_MAJOR_VERSION > 5 && GAZEBO_MAJOR_VERSION < 8
+	msgs::Set(factory_msg.mutable_pose(), pose.Ign());
+#else
+	msgs::Set(factory_msg.mutable_pose(), pose);
+#endif
+	factory_pub_->Publish(factory_msg);
+	return true;
+}
+
+gzwrap::Pose3d
+WorkpiecePool::parking_pose(std::size_t slot) const
+{
+	return gzwrap::Pose3d(parking_position_[0] + (slot % 10) * parking_spacing_,
+	                      parking_position_[1] + (slot / 10) * parking_spacing_,
+	                      parking_position_[2],
+	                      0,
+	                      0,
+	                      0);
+}
+
+/** Move a workpiece to its parking position and disable its physics. */
+void
+WorkpiecePool::park(physics::ModelPtr model, std::size_t slot)
+{
+	model->SetWorldPose(parking_pose(slot));
+	model->ResetPhysicsStates();
+	model->SetEnabled(false);
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ *  workpiece_pool.h - Recycle workpiece models instead of spawning new ones
+ *
+ *  Created:   Sun 18 Oct 22:17:25 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <configurable/configurable.h>
+#include <gazsim_msgs/WorkpieceCommand.pb.h>
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/weak_ptr.hpp>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gazebo {
+
+/** Pool of workpiece models parked off-field.
+ * There is one pool per world, shared by all stations of that world. At
+ * startup it spawns a number of workpieces and parks them with physics
+ * disabled. A station in need of a workpiece checks one out, which moves it
+ * to the requested pose and resets it to a bare base of the requested color.
+ * The model is only touched with the next world update, so workpieces may be
+ * checked out from any thread. Delivered workpieces are checked in and
+ * parked again. Only if the pool is empty, a new workpiece is spawned
+ * through the factory.
+ */
+class WorkpiecePool : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	static std::shared_ptr<WorkpiecePool> instance(physics::WorldPtr world);
+	~WorkpiecePool();
+
+	std::string spawn(const gzwrap::Pose3d &pose, gazsim_msgs::Color base_color);
+	void        checkin(const physics::ModelPtr &workpiece);
+
+private:
+	explicit WorkpiecePool(physics::WorldPtr world);
+	void           on_update();
+	bool           spawn_model(const std::string &   name,
+	                           const gzwrap::Pose3d &pose,
+	                           gazsim_msgs::Color    base_color);
+	gzwrap::Pose3d parking_pose(std::size_t slot) const;
+	void           park(physics::ModelPtr model, std::size_t slot);
+
+	struct Slot
+	{
+		enum State {
+			/// spawned, but not yet found in the world
+			SPAWNING,
+			/// parked and free to be checked out
+			PARKED,
+			/// checked out, moved to its pose with the next world update
+			CHECKED_OUT,
+			/// checked out by a station
+			IN_USE,
+		};
+
+		std::string                     name;
+		boost::weak_ptr<physics::Model> model;
+		State                           state;
+		/// where to put the workpiece once it is checked out
+		gzwrap::Pose3d pose;
+		/// the base color to reset the workpiece to once it is checked out
+		gazsim_msgs::Color base_color;
+	};
+
+	physics::WorldPtr       world_;
+	transport::NodePtr      node_;
+	transport::PublisherPtr factory_pub_;
+	transport::PublisherPtr puck_cmd_pub_;
+	event::ConnectionPtr    update_connection_;
+	std::vector<float>      parking_position_;
+	float                   parking_spacing_;
+	unsigned int            size_;
+	bool                    spawned_;
+
+	std::mutex                                   mutex_;
+	std::vector<Slot>                            slots_;
+	std::unordered_map<std::string, std::size_t> slot_by_name_;
+	/// number of slots in state SPAWNING
+	std::size_t spawning_;
+	/// number of slots in state CHECKED_OUT
+	std::size_t checked_out_;
+};
+
+} // namespace gazebo
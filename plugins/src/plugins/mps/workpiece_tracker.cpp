@@ -0,0 +1,379 @@
+/***************************************************************************
+ *  workpiece_tracker.cpp - Spatial index of the workpieces of a world
+ *
+ *  Created:   Sun 18 Oct 20:11:36 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "workpiece_tracker.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <cmath>
+#include <iterator>
+
+using namespace gazebo;
+
+/** Get the workpiece tracker of a world.
+ * @param world the world to get the tracker for
+ * @return the tracker of the given world
+ */
+std::shared_ptr<WorkpieceTracker>
+WorkpieceTracker::instance(physics::WorldPtr world)
+{
+	static std::mutex                                              instances_mutex;
+	static std::map<std::string, std::weak_ptr<WorkpieceTracker>> instances;
+
+	std::lock_guard<std::mutex>       lock{instances_mutex};
+	const std::string                 name    = world->GZWRAP_NAME();
+	std::shared_ptr<WorkpieceTracker> tracker = instances[name].lock();
+	if (!tracker) {
+		tracker         = std::shared_ptr<WorkpieceTracker>(new WorkpieceTracker(world));
+		instances[name] = tracker;
+	}
+	return tracker;
+}
+
+WorkpieceTracker::WorkpieceTracker(physics::WorldPtr world)
+: world_(world), next_zone_(0), dispatching_owner_(nullptr)
+{
+	cell_size_ = config->get_float("plugins/mps/workpiece_grid_cell_size");
+
+	node_ = transport::NodePtr(new transport::Node());
+	node_->Init(world_->GZWRAP_NAME());
+	new_puck_sub_ = node_->Subscribe("~/new_puck", &WorkpieceTracker::on_new_puck, this);
+	joint_sub_    = node_->Subscribe(config->get_string("plugins/mps/topic_joint"),
+	                                 &WorkpieceTracker::on_joint_msg,
+	                                 this);
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&WorkpieceTracker::on_update, this));
+}
+
+WorkpieceTracker::~WorkpieceTracker()
+{
+	update_connection_.reset();
+	new_puck_sub_.reset();
+	joint_sub_.reset();
+}
+
+/** Add a zone to watch.
+ * Workpieces which are already in the zone are reported as entered with the
+ * next update.
+ * @param owner the object the zone belongs to, used for remove_zones()
+ * @param center the center of the zone in world coordinates
+ * @param radius a workpiece is in the zone if it is closer than this to the center
+ * @param callback called whenever a workpiece enters or leaves the zone
+ * @return the ID of the zone
+ */
+WorkpieceTracker::ZoneId
+WorkpieceTracker::add_zone(const void *             owner,
+                           const gzwrap::Vector3d &center,
+                           double                  radius,
+                           ZoneCallback            callback)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	ZoneId                      id = next_zone_++;
+	zones_.emplace(id, Zone{owner, center, radius, std::move(callback), {}});
+	return id;
+}
+
+/** Remove all zones of an owner.
+ * If a callback of the owner is currently running, wait for it to finish, so
+ * the owner can safely be destroyed afterwards. If called from within a
+ * callback, the running callback is not waited for.
+ * @param owner the owner whose zones to remove
+ */
+void
+WorkpieceTracker::remove_zones(const void *owner)
+{
+	std::unique_lock<std::mutex> lock{mutex_};
+	for (auto it = zones_.begin(); it != zones_.end();) {
+		if (it->second.owner == owner) {
+			it = zones_.erase(it);
+		} else {
+			++it;
+		}
+	}
+	if (dispatching_thread_ != std::this_thread::get_id()) {
+		dispatched_.wait(lock, [this, owner] { return dispatching_owner_ != owner; });
+	}
+}
+
+/** Get all workpieces close to a position.
+ * The positions are the ones read at the beginning of the current step.
+ * @param center the position in world coordinates
+ * @param radius max distance of a workpiece to the position
+ * @return the workpieces closer than radius to center
+ */
+std::vector<physics::ModelPtr>
+WorkpieceTracker::workpieces_near(const gzwrap::Vector3d &center, double radius)
+{
+	std::lock_guard<std::mutex>    lock{mutex_};
+	std::vector<physics::ModelPtr> result;
+	for_each_near(center, radius, [&result](uint32_t, const Workpiece &workpiece) {
+		physics::ModelPtr model = workpiece.model.lock();
+		if (model) {
+			result.push_back(model);
+		}
+	});
+	return result;
+}
+
+/** Check whether a workpiece is known to the tracker.
+ * @param name the name of the workpiece
+ * @return true if the workpiece was announced and found in the world
+ */
+bool
+WorkpieceTracker::contains(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	return ids_.find(name) != ids_.end();
+}
+
+/** Check whether a workpiece is held by a gripper.
+ * @param name the name of the workpiece
+ * @return true if a gripper's joint holds the workpiece
+ */
+bool
+WorkpieceTracker::is_held(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        id = ids_.find(name);
+	return id != ids_.end() && workpieces_[id->second].held;
+}
+
+/** Get the zone a workpiece is in.
+ * @param name the name of the workpiece
+ * @return the zone the workpiece entered last, NO_ZONE if it is in none
+ */
+WorkpieceTracker::ZoneId
+WorkpieceTracker::zone_of(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        id = ids_.find(name);
+	return id != ids_.end() ? workpieces_[id->second].zone : NO_ZONE;
+}
+
+void
+WorkpieceTracker::on_new_puck(const boost::shared_ptr<gazsim_msgs::NewPuck const> &msg)
+{
+	// The model is looked up in the update thread, not while the world may be stepping.
+	std::lock_guard<std::mutex> lock{mutex_};
+	pending_.push_back(msg->puck_name());
+}
+
+/** Update the holder index from a gripper's joint message.
+ * A joint holds at most one workpiece, an empty child releases it.
+ */
+void
+WorkpieceTracker::on_joint_msg(ConstJointPtr &msg)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        held = held_by_.find(msg->id());
+	if (held != held_by_.end()) {
+		workpieces_[held->second].held = false;
+		held_by_.erase(held);
+	}
+	auto id = ids_.find(msg->child());
+	if (id == ids_.end()) {
+		return;
+	}
+	Workpiece &workpiece = workpieces_[id->second];
+	if (workpiece.held) {
+		held_by_.erase(workpiece.holder);
+	}
+	workpiece.held      = true;
+	workpiece.holder    = msg->id();
+	held_by_[msg->id()] = id->second;
+}
+
+/** Free the ID of a deleted workpiece.
+ * Must be called with the mutex held.
+ */
+void
+WorkpieceTracker::release(uint32_t id)
+{
+	Workpiece &workpiece = workpieces_[id];
+	if (workpiece.held) {
+		held_by_.erase(workpiece.holder);
+	}
+	ids_.erase(workpiece.name);
+	workpiece   = Workpiece();
+	in_use_[id] = false;
+	free_ids_.push_back(id);
+}
+
+int64_t
+WorkpieceTracker::cell_of(double coord) const
+{
+	return int64_t(std::floor(coord / cell_size_));
+}
+
+int64_t
+WorkpieceTracker::cell_key(int64_t x, int64_t y) const
+{
+	return int64_t(uint64_t(x) << 32 | (uint64_t(y) & 0xffffffff));
+}
+
+/** Call a visitor for every workpiece closer than radius to center.
+ * Only the cells overlapped by the circle around center are searched.
+ * Must be called with the mutex held.
+ */
+template <class Visitor>
+void
+WorkpieceTracker::for_each_near(const gzwrap::Vector3d &center,
+                                double                  radius,
+                                Visitor                 visit) const
+{
+	const int64_t min_x = cell_of(center.GZWRAP_X - radius);
+	const int64_t max_x = cell_of(center.GZWRAP_X + radius);
+	const int64_t min_y = cell_of(center.GZWRAP_Y - radius);
+	const int64_t max_y = cell_of(center.GZWRAP_Y + radius);
+	for (int64_t x = min_x; x <= max_x; x++) {
+		for (int64_t y = min_y; y <= max_y; y++) {
+			auto cell = grid_.find(cell_key(x, y));
+			if (cell == grid_.end()) {
+				continue;
+			}
+			for (uint32_t id : cell->second) {
+				const Workpiece &workpiece = workpieces_[id];
+				if ((workpiece.position - center).GZWRAP_LENGTH() < radius) {
+					visit(id, workpiece);
+				}
+			}
+		}
+	}
+}
+
+void
+WorkpieceTracker::on_update()
+{
+	std::unique_lock<std::mutex> lock{mutex_};
+
+	for (auto name = pending_.begin(); name != pending_.end();) {
+		physics::ModelPtr model = world_->GZWRAP_MODEL_BY_NAME(*name);
+		if (!model) {
+			++name;
+			continue;
+		}
+		if (ids_.find(*name) == ids_.end()) {
+			gzwrap::Vector3d position = model->GZWRAP_WORLD_POSE().GZWRAP_POS;
+			int64_t  cell = cell_key(cell_of(position.GZWRAP_X), cell_of(position.GZWRAP_Y));
+			uint32_t id   = uint32_t(workpieces_.size());
+			if (free_ids_.empty()) {
+				workpieces_.emplace_back();
+				in_use_.push_back(true);
+			} else {
+				id = free_ids_.back();
+				free_ids_.pop_back();
+				in_use_[id] = true;
+			}
+			workpieces_[id] = Workpiece{model, *name, position, cell, NO_ZONE, false, 0};
+			ids_[*name]     = id;
+			grid_[cell].push_back(id);
+		}
+		name = pending_.erase(name);
+	}
+
+	// Move the workpieces to their current cell, unlink deleted ones from the grid.
+	std::vector<uint32_t> deleted;
+	for (uint32_t id = 0; id < workpieces_.size(); id++) {
+		if (!in_use_[id]) {
+			continue;
+		}
+		Workpiece &       workpiece = workpieces_[id];
+		physics::ModelPtr model     = workpiece.model.lock();
+		int64_t           cell      = workpiece.cell;
+		if (model) {
+			workpiece.position = model->GZWRAP_WORLD_POSE().GZWRAP_POS;
+			cell = cell_key(cell_of(workpiece.position.GZWRAP_X), cell_of(workpiece.position.GZWRAP_Y));
+			if (cell == workpiece.cell) {
+				continue;
+			}
+		} else {
+			deleted.push_back(id);
+		}
+		std::vector<uint32_t> &old_cell = grid_[workpiece.cell];
+		old_cell.erase(std::find(old_cell.begin(), old_cell.end(), id));
+		if (old_cell.empty()) {
+			grid_.erase(workpiece.cell);
+		}
+		if (model) {
+			grid_[cell].push_back(id);
+			workpiece.cell = cell;
+		}
+	}
+
+	std::vector<Event> events;
+	for (auto &entry : zones_) {
+		Zone &                zone = entry.second;
+		std::vector<uint32_t> inside;
+		for_each_near(zone.center, zone.radius, [&inside](uint32_t id, const Workpiece &) {
+			inside.push_back(id);
+		});
+		std::sort(inside.begin(), inside.end());
+		if (inside == zone.inside) {
+			continue;
+		}
+		std::vector<uint32_t> entered, left;
+		std::set_difference(inside.begin(),
+		                    inside.end(),
+		                    zone.inside.begin(),
+		                    zone.inside.end(),
+		                    std::back_inserter(entered));
+		std::set_difference(zone.inside.begin(),
+		                    zone.inside.end(),
+		                    inside.begin(),
+		                    inside.end(),
+		                    std::back_inserter(left));
+		for (uint32_t id : left) {
+			Workpiece &workpiece = workpieces_[id];
+			if (workpiece.zone == entry.first) {
+				workpiece.zone = NO_ZONE;
+			}
+			events.push_back(Event{entry.first,
+			                       zone.owner,
+			                       {WorkpieceEvent::LEFT, workpiece.name, workpiece.model.lock()}});
+		}
+		for (uint32_t id : entered) {
+			Workpiece &workpiece = workpieces_[id];
+			workpiece.zone       = entry.first;
+			events.push_back(Event{entry.first,
+			                       zone.owner,
+			                       {WorkpieceEvent::ENTERED, workpiece.name, workpiece.model.lock()}});
+		}
+		zone.inside.swap(inside);
+	}
+	for (uint32_t id : deleted) {
+		release(id);
+	}
+
+	// Callbacks may add zones or query the tracker, so never hold the lock while running them.
+	dispatching_thread_ = std::this_thread::get_id();
+	for (const Event &event : events) {
+		auto zone = zones_.find(event.zone);
+		if (zone == zones_.end()) {
+			continue;
+		}
+		ZoneCallback callback = zone->second.callback;
+		dispatching_owner_    = event.owner;
+		lock.unlock();
+		callback(event.event);
+		lock.lock();
+		dispatching_owner_ = nullptr;
+		dispatched_.notify_all();
+	}
+	dispatching_thread_ = std::thread::id();
+}
@@ -0,0 +1,152 @@
+/***************************************************************************
+ *  workpiece_tracker.h - Spatial index of the workpieces of a world
+ *
+ *  Created:   Sun 18 Oct 20:11:36 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <configurable/configurable.h>
+#include <gazsim_msgs/NewPuck.pb.h>
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/weak_ptr.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gazebo {
+
+/** A workpiece entered or left a zone. */
+struct WorkpieceEvent
+{
+	enum Type { ENTERED, LEFT };
+
+	Type        type;
+	std::string name;
+	/// the workpiece, null if it left the zone because it was deleted
+	physics::ModelPtr model;
+};
+
+/** Registry and spatial index of all workpieces of a world.
+ * There is one tracker per world, shared by all stations of that world. It
+ * learns about workpieces from the ~/new_puck announcements and reads their
+ * positions from physics once per step. The positions are kept in a uniform
+ * grid, so a zone only has to look at the workpieces in the cells it overlaps.
+ * Stations register their zones and get called when a workpiece enters or
+ * leaves one of them. Events are delivered in the world update thread.
+ * Each workpiece gets a dense integer ID, which is reused once the workpiece
+ * is deleted. The tracker also listens to the grippers' joint messages and
+ * keeps an index from the holding joint to the held workpiece.
+ */
+class WorkpieceTracker : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	typedef std::function<void(const WorkpieceEvent &)> ZoneCallback;
+	typedef uint32_t                                    ZoneId;
+	static constexpr ZoneId                             NO_ZONE = ZoneId(-1);
+
+	static std::shared_ptr<WorkpieceTracker> instance(physics::WorldPtr world);
+	~WorkpieceTracker();
+
+	ZoneId add_zone(const void *             owner,
+	                const gzwrap::Vector3d &center,
+	                double                  radius,
+	                ZoneCallback            callback);
+	void   remove_zones(const void *owner);
+
+	std::vector<physics::ModelPtr> workpieces_near(const gzwrap::Vector3d &center, double radius);
+	bool                           contains(const std::string &name);
+	bool                           is_held(const std::string &name);
+	ZoneId                         zone_of(const std::string &name);
+
+private:
+	explicit WorkpieceTracker(physics::WorldPtr world);
+	void    on_new_puck(const boost::shared_ptr<gazsim_msgs::NewPuck const> &msg);
+	void    on_joint_msg(ConstJointPtr &msg);
+	void    on_update();
+	void    release(uint32_t id);
+	int64_t cell_key(int64_t x, int64_t y) const;
+	int64_t cell_of(double coord) const;
+	template <class Visitor>
+	void for_each_near(const gzwrap::Vector3d &center, double radius, Visitor visit) const;
+
+	struct Workpiece
+	{
+		boost::weak_ptr<physics::Model> model;
+		std::string                     name;
+		gzwrap::Vector3d                position;
+		int64_t                         cell;
+		/// the zone the workpiece entered last, NO_ZONE if it is in none
+		ZoneId zone;
+		/// the joint holding the workpiece, if held
+		bool     held;
+		uint32_t holder;
+	};
+
+	struct Zone
+	{
+		const void *     owner;
+		gzwrap::Vector3d center;
+		double           radius;
+		ZoneCallback     callback;
+		/// IDs of the workpieces currently in the zone
+		std::vector<uint32_t> inside;
+	};
+
+	struct Event
+	{
+		ZoneId         zone;
+		const void *   owner;
+		WorkpieceEvent event;
+	};
+
+	physics::WorldPtr        world_;
+	transport::NodePtr       node_;
+	transport::SubscriberPtr new_puck_sub_;
+	transport::SubscriberPtr joint_sub_;
+	event::ConnectionPtr     update_connection_;
+	double                   cell_size_;
+
+	std::mutex mutex_;
+	/// workpieces announced but not yet found in the world
+	std::vector<std::string> pending_;
+	/// workpieces by ID, the slots of deleted workpieces are free for reuse
+	std::vector<Workpiece>                             workpieces_;
+	std::vector<bool>                                  in_use_;
+	std::vector<uint32_t>                              free_ids_;
+	std::unordered_map<std::string, uint32_t>          ids_;
+	std::unordered_map<uint32_t, uint32_t>             held_by_;
+	std::unordered_map<int64_t, std::vector<uint32_t>> grid_;
+	std::map<ZoneId, Zone>                             zones_;
+	ZoneId                                             next_zone_;
+
+	std::condition_variable dispatched_;
+	const void *            dispatching_owner_;
+	std::thread::id         dispatching_thread_;
+};
+
+} // namespace gazebo
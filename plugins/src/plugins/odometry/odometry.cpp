@@ -52,7 +52,16 @@ Odometry::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	estimate_y     = 0;
 	estimate_omega = 0;
 
-	last_sent_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+	last_update_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+	robot_state_      = RobotStateHub::instance(model_);
+
+	const std::string publication = "plugins/odometry/publication/";
+
+	publication_policy_ = std::unique_ptr<gazebo_rcll::PublicationPolicy>(
+	  new gazebo_rcll::PublicationPolicy(config->get_float(publication + "max_rate"),
+	                                     config->get_float(publication + "min_rate"),
+	                                     config->get_float(publication + "position_epsilon"),
+	                                     config->get_float(publication + "angle_epsilon")));
 
 	//get the model-name
 	this->name_ = model_->GetName();
@@ -69,9 +78,6 @@ Odometry::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
 	//the namespace is set to the model name!
 	this->node_->Init(model_->GetWorld()->GZWRAP_NAME() + "/" + name_);
 
-	//init last sent time
-	last_sent_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
-
 	//create publisher
 	this->odometry_pub_ = this->node_->Advertise<msgs::Vector3d>("~/RobotinoSim/Odometry/");
 
@@ -88,9 +94,9 @@ Odometry::OnUpdate(const common::UpdateInfo & /*_info*/)
 {
 	//Send position information to Fawkes
 	double time = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
-	if (time - last_sent_time_ > (1.0 / 10.0)) {
+	if (time - last_update_time_ > publication_policy_->min_interval()) {
 		send_position();
-		last_sent_time_ = time;
+		last_update_time_ = time;
 	}
 }
 
@@ -110,15 +116,16 @@ Odometry::on_set_odometry_msg(ConstVector3dPtr &msg)
 	//std::cout << "Got new odometry: " << msg->x() << "|" << msg->y() << "|" << msg->z() << std::endl;
 	{
 		boost::mutex::scoped_lock lock(readingsMutex);
-		estimate_x      = msg->x();
-		estimate_y      = msg->y();
-		estimate_omega  = msg->z();
-		last_sent_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+		estimate_x        = msg->x();
+		estimate_y        = msg->y();
+		estimate_omega    = msg->z();
+		last_update_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+		robot_state_->set_odometry(estimate_x, estimate_y, estimate_omega);
 	}
 }
 
-/** Sending position to Fawkes
- * 
+/** Update the estimate and send it to Fawkes if it changed or the
+ * heartbeat is due.
  */
 void
 Odometry::send_position()
@@ -127,7 +134,8 @@ Odometry::send_position()
 	gzwrap::Vector3d angularVel = this->model_->GZWRAP_RELATIVE_ANGULAR_VEL();
 
 	//get the elapsed time since last update
-	double elapsedSeconds = model_->GetWorld()->GZWRAP_SIM_TIME().Double() - last_sent_time_;
+	double time           = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+	double elapsedSeconds = time - last_update_time_;
 
 	//now add some simulated error
 	// rand multiplied by max noise which is in seconds
@@ -153,9 +161,14 @@ Odometry::send_position()
 			estimate_omega = 2 * M_PI - estimate_omega;
 		else if (estimate_omega > M_PI)
 			estimate_omega = -2 * M_PI + estimate_omega;
+		robot_state_->set_odometry(estimate_x, estimate_y, estimate_omega);
 	}
 
-	if (odometry_pub_->HasConnections()) {
+	if (odometry_pub_->HasConnections()
+	    && publication_policy_->check(publication_,
+	                                  time,
+	                                  {estimate_x, estimate_y},
+	                                  {estimate_omega})) {
 		//build message
 		msgs::Vector3d posMsg;
 		posMsg.set_x(estimate_x);
@@ -18,6 +18,11 @@
  *  Read the full text in the LICENSE.GPL file in the doc directory.
  */
 
+#include "../robot-state/robot_state_hub.h"
+
+#include <configurable/configurable.h>
+#include <utils/misc/publication_policy.h>
+
 #include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
 #include <gazebo/common/common.hh>
@@ -25,6 +30,7 @@
 #include <gazebo/physics/physics.hh>
 #include <gazebo/transport/transport.hh>
 #include <list>
+#include <memory>
 #include <stdio.h>
 #include <string.h>
 
@@ -33,7 +39,7 @@ namespace gazebo {
     * Provides odometry simulation of object model
     * @author Stefan Profanter
     */
-class Odometry : public ModelPlugin
+class Odometry : public ModelPlugin, public gazebo_rcll::ConfigurableAspect
 {
 public:
 	Odometry();
@@ -54,8 +60,14 @@ private:
 	///name of the gps and the communication channel
 	std::string name_;
 
-	///time variable to send in intervals
-	double last_sent_time_;
+	///time of the last update of the estimate
+	double last_update_time_;
+	///when and which estimate was last sent
+	gazebo_rcll::PublicationState publication_;
+	///when to update and send the estimate, only changes are sent
+	std::unique_ptr<gazebo_rcll::PublicationPolicy> publication_policy_;
+	///Values for the fused state of the robot
+	std::shared_ptr<RobotStateHub> robot_state_;
 
 	//Odometry Stuff:
 
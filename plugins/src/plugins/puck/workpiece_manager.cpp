@@ -0,0 +1,505 @@
+/***************************************************************************
+ *  workpiece_manager.cpp - Command routing and visuals of all workpieces
+ *
+ *  Created:   Sun 18 Oct 21:03:52 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "workpiece_manager.h"
+
+#include <gazsim_msgs/NewPuck.pb.h>
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/bind.hpp>
+
+using namespace gazebo;
+
+/** Create the material of a workpiece color.
+ * @param clr the color
+ * @return the material to use for visuals of that color
+ */
+static msgs::Material
+make_material(gazsim_msgs::Color clr)
+{
+	msgs::Material material;
+	switch (clr) {
+	case gazsim_msgs::Color::RED:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(1, 0, 0));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(1, 0, 0));
+		break;
+	case gazsim_msgs::Color::BLUE:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(0, 0, 1));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(0, 0, 1));
+		break;
+	case gazsim_msgs::Color::GREEN:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(0, 1, 0));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(0, 1, 0));
+		break;
+	case gazsim_msgs::Color::BLACK:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(0, 0, 0, 0));
+
+		break;
+	case gazsim_msgs::Color::YELLOW:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(255, 255, 0));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(1, 1, 0));
+		break;
+	case gazsim_msgs::Color::ORANGE:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(255, 127, 0));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(1, 0.5, 0));
+		break;
+	case gazsim_msgs::Color::SILVER:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(.8f, .8f, .8f));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(0, 0, 0));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(.8f, .8f, .8f));
+		break;
+	case gazsim_msgs::Color::GREY:
+	default:
+		msgs::Set(material.mutable_diffuse(), gzwrap::Color(.2f, .2f, .2f));
+		msgs::Set(material.mutable_emissive(), gzwrap::Color(.2f, .2f, .2f, .2f));
+		msgs::Set(material.mutable_ambient(), gzwrap::Color(.2f, .2f, .2f, .2f));
+		break;
+	}
+	return material;
+}
+
+/** Set the material of a visual to a workpiece color.
+ * The materials of all colors are created once and copied from then on.
+ * @param visual the visual message to set the material of
+ * @param clr the color
+ */
+static void
+set_color(msgs::Visual &visual, gazsim_msgs::Color clr)
+{
+	static const std::vector<msgs::Material> materials = [] {
+		std::vector<msgs::Material> materials;
+		for (int i = gazsim_msgs::Color_MIN; i <= gazsim_msgs::Color_MAX; i++) {
+			materials.push_back(make_material(gazsim_msgs::Color(i)));
+		}
+		return materials;
+	}();
+	visual.mutable_material()->CopyFrom(materials.at(clr - gazsim_msgs::Color_MIN));
+}
+
+/** Get the workpiece manager of a world.
+ * @param world the world to get the manager for
+ * @return the manager of the given world
+ */
+std::shared_ptr<WorkpieceManager>
+WorkpieceManager::instance(physics::WorldPtr world)
+{
+	static std::mutex                                              instances_mutex;
+	static std::map<std::string, std::weak_ptr<WorkpieceManager>> instances;
+
+	std::lock_guard<std::mutex>       lock{instances_mutex};
+	const std::string                 name    = world->GZWRAP_NAME();
+	std::shared_ptr<WorkpieceManager> manager = instances[name].lock();
+	if (!manager) {
+		manager         = std::shared_ptr<WorkpieceManager>(new WorkpieceManager(world));
+		instances[name] = manager;
+	}
+	return manager;
+}
+
+WorkpieceManager::WorkpieceManager(physics::WorldPtr world) : world_(world)
+{
+	ring_height_             = config->get_float("plugins/puck/ring_height");
+	cap_height_              = config->get_float("plugins/puck/cap_height");
+	workpiece_height_        = config->get_float("plugins/puck/workpiece_height");
+	freeze_rest_steps_       = config->get_uint("plugins/puck/freeze/rest_steps");
+	freeze_linear_velocity_  = config->get_float("plugins/puck/freeze/linear_velocity");
+	freeze_angular_velocity_ = config->get_float("plugins/puck/freeze/angular_velocity");
+	journal_                 = gazebo_rcll::WorkpieceJournal::open(
+	  config->get_string("plugins/journal/file"), config->get_uint("plugins/journal/capacity"));
+
+	node_ = transport::NodePtr(new transport::Node());
+	// the namespace is set to the world name!
+	node_->Init(world_->GZWRAP_NAME());
+
+	visual_pub_   = node_->Advertise<msgs::Visual>("~/visual");
+	new_puck_pub_ = node_->Advertise<gazsim_msgs::NewPuck>("~/new_puck");
+	result_pub_   = node_->Advertise<gazsim_msgs::WorkpieceResult>("~/pucks/cmd/result");
+	delivery_pub_ = node_->Advertise<llsf_msgs::SetOrderDeliveredByColor>(
+	  config->get_string("plugins/puck/topic_set_order_delivery_by_color"));
+	command_sub_ = node_->Subscribe("~/pucks/cmd", &WorkpieceManager::on_command_msg, this);
+
+	update_connection_ =
+	  event::Events::ConnectWorldUpdateBegin(boost::bind(&WorkpieceManager::on_update, this));
+}
+
+WorkpieceManager::~WorkpieceManager()
+{
+	update_connection_.reset();
+	command_sub_.reset();
+}
+
+/** Add a workpiece.
+ * The workpiece is announced on ~/new_puck with the next world update.
+ * @param model the model of the workpiece
+ * @param base_color the color of the workpiece's base
+ */
+void
+WorkpieceManager::add_workpiece(physics::ModelPtr model, gazsim_msgs::Color base_color)
+{
+	std::unique_ptr<WorkpieceState> workpiece(new WorkpieceState);
+	workpiece->name          = model->GetName();
+	workpiece->model         = model;
+	workpiece->base_color    = base_color;
+	workpiece->have_cap      = false;
+	workpiece->cap_color     = gazsim_msgs::Color::NONE;
+	workpiece->resting_steps = 0;
+	workpiece->radius        = 0;
+
+	std::lock_guard<std::mutex> lock{mutex_};
+	unannounced_.push_back(workpiece->name);
+	workpieces_[workpiece->name] = std::move(workpiece);
+}
+
+/** Remove a workpiece, e.g. because its model is deleted.
+ * @param name the name of the workpiece
+ */
+void
+WorkpieceManager::remove_workpiece(const std::string &name)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	workpieces_.erase(name);
+}
+
+/** Freeze resting workpieces, publish the visual changes and announce the
+ * workpieces added since the last update.
+ */
+void
+WorkpieceManager::on_update()
+{
+	std::vector<std::string>  names;
+	std::vector<msgs::Visual> visuals;
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		freeze_resting();
+		names.swap(unannounced_);
+		visuals.swap(pending_visuals_);
+		pending_visual_index_.clear();
+	}
+	for (const msgs::Visual &visual : visuals) {
+		visual_pub_->Publish(visual);
+	}
+	for (const std::string &name : names) {
+		gazsim_msgs::NewPuck new_puck_msg;
+		new_puck_msg.set_puck_name(name);
+		new_puck_msg.set_gps_topic("~/" + name + "/gazsim/gps/");
+		new_puck_pub_->Publish(new_puck_msg);
+	}
+}
+
+/** Queue a visual change to be published with the next update.
+ * All changes of a step are published together, a later change of the same
+ * visual replaces an earlier one. Must be called with the mutex held.
+ * @param visual the complete visual message
+ */
+void
+WorkpieceManager::queue_visual(msgs::Visual &&visual)
+{
+	auto queued = pending_visual_index_.find(visual.name());
+	if (queued != pending_visual_index_.end()) {
+		pending_visuals_[queued->second] = std::move(visual);
+		return;
+	}
+	pending_visual_index_[visual.name()] = pending_visuals_.size();
+	pending_visuals_.push_back(std::move(visual));
+}
+
+/** Disable the physics of workpieces which did not move for some steps.
+ * Frozen workpieces only cost a flag check. A workpiece held by a joint is
+ * never frozen, the joint would wake it again in the next step anyway.
+ * Must be called with the mutex held.
+ */
+void
+WorkpieceManager::freeze_resting()
+{
+	if (freeze_rest_steps_ == 0) {
+		return;
+	}
+	for (auto &entry : workpieces_) {
+		WorkpieceState &  workpiece = *entry.second;
+		physics::ModelPtr model     = workpiece.model.lock();
+		if (!model) {
+			continue;
+		}
+		physics::LinkPtr link = model->GetLink();
+		if (!link || !link->GetEnabled() || !link->GetParentJoints().empty()) {
+			workpiece.resting_steps = 0;
+			continue;
+		}
+		if (model->GZWRAP_WORLD_LINEAR_VEL().GZWRAP_LENGTH() > freeze_linear_velocity_
+		    || model->GZWRAP_WORLD_ANGULAR_VEL().GZWRAP_LENGTH() > freeze_angular_velocity_) {
+			workpiece.resting_steps = 0;
+			continue;
+		}
+		if (++workpiece.resting_steps >= freeze_rest_steps_) {
+			model->SetEnabled(false);
+			workpiece.resting_steps = 0;
+		}
+	}
+}
+
+/** Route a workpiece command to the addressed workpiece.
+ * @param cmd the command
+ */
+void
+WorkpieceManager::on_command_msg(ConstWorkpieceCommandPtr &cmd)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	auto                        entry = workpieces_.find(cmd->puck_name());
+	if (entry == workpieces_.end()) {
+		return;
+	}
+	WorkpieceState &workpiece = *entry->second;
+	printf("puck %s recieved command: ", workpiece.name.c_str());
+	switch (cmd->command()) {
+	case gazsim_msgs::Command::ADD_RING:
+		for (int i = 0; i < cmd->color_size(); i++) {
+			printf("add ring with color: %s\n", gazsim_msgs::Color_Name(cmd->color(i)).c_str());
+			add_ring(workpiece, cmd->color(i));
+			journal(gazebo_rcll::JournalEvent::RING, workpiece, cmd->color(i));
+		}
+		break;
+	case gazsim_msgs::Command::ADD_CAP:
+		printf("add cap with color: %s\n", gazsim_msgs::Color_Name(cmd->color(0)).c_str());
+		add_cap(workpiece, cmd->color(0));
+		journal(gazebo_rcll::JournalEvent::CAP, workpiece, cmd->color(0));
+		break;
+	case gazsim_msgs::Command::REMOVE_CAP:
+		if (workpiece.have_cap) {
+			printf("remove cap, providing cap color %s\n",
+			       gazsim_msgs::Color_Name(workpiece.cap_color).c_str());
+			journal(gazebo_rcll::JournalEvent::CAP_REMOVED, workpiece, workpiece.cap_color);
+			remove_cap(workpiece);
+		} else {
+			printf("Can't remove any cap from this workpiece\n");
+			publish_result(workpiece, gazsim_msgs::Color::NONE);
+		}
+		break;
+	case gazsim_msgs::Command::DELIVER:
+		journal(gazebo_rcll::JournalEvent::DELIVER, workpiece, cmd->team_color());
+		deliver(workpiece, cmd->team_color());
+		break;
+	case gazsim_msgs::Command::RESET: {
+		gazsim_msgs::Color base_color = cmd->color_size() > 0 ? cmd->color(0) : workpiece.base_color;
+		printf("reset to a bare %s base\n", gazsim_msgs::Color_Name(base_color).c_str());
+		reset(workpiece, base_color);
+		break;
+	}
+	default: printf("unknowen"); break;
+	}
+}
+
+/** Add an event to the workpiece journal, if enabled.
+ * The station of a command is not known, so the subject is left empty.
+ */
+void
+WorkpieceManager::journal(gazebo_rcll::JournalEvent event,
+                          const WorkpieceState &    workpiece,
+                          uint16_t                  value)
+{
+	if (journal_) {
+		journal_->record(event, world_->GZWRAP_SIM_TIME().Double(), workpiece.name, "", value);
+	}
+}
+
+void
+WorkpieceManager::add_ring(WorkpieceState &workpiece, gazsim_msgs::Color clr)
+{
+	// create the ring name and add a new ring
+	std::string ring_name = std::string("ring_") + std::to_string(workpiece.ring_colors.size());
+
+	queue_visual(create_visual_msg(workpiece, ring_name, ring_height_, clr));
+	workpiece.ring_colors.push_back(clr);
+}
+
+void
+WorkpieceManager::add_cap(WorkpieceState &workpiece, gazsim_msgs::Color clr)
+{
+	queue_visual(create_visual_msg(workpiece, "cap", cap_height_, clr));
+	workpiece.have_cap  = true;
+	workpiece.cap_color = clr;
+}
+
+void
+WorkpieceManager::remove_cap(WorkpieceState &workpiece)
+{
+	msgs::Visual vis_msg = create_visual_msg(workpiece, "cap", cap_height_, gazsim_msgs::Color::RED);
+	vis_msg.set_visible(false);
+
+	queue_visual(std::move(vis_msg));
+	publish_result(workpiece, workpiece.cap_color);
+	workpiece.have_cap = false;
+}
+
+/** Reset a recycled workpiece to a bare base.
+ * Rings and cap are hidden and the base is recolored. The workpiece is then
+ * announced again, so the stations treat it like a newly spawned one.
+ * @param workpiece the workpiece to reset
+ * @param base_color the new color of the base
+ */
+void
+WorkpieceManager::reset(WorkpieceState &workpiece, gazsim_msgs::Color base_color)
+{
+	std::size_t ring_count = workpiece.ring_colors.size();
+	workpiece.ring_colors.clear();
+	for (std::size_t i = 0; i < ring_count; i++) {
+		msgs::Visual vis_msg = create_visual_msg(
+		  workpiece, "ring_" + std::to_string(i), ring_height_, gazsim_msgs::Color::RED);
+		vis_msg.set_visible(false);
+		queue_visual(std::move(vis_msg));
+	}
+	if (workpiece.have_cap) {
+		msgs::Visual vis_msg =
+		  create_visual_msg(workpiece, "cap", cap_height_, gazsim_msgs::Color::RED);
+		vis_msg.set_visible(false);
+		queue_visual(std::move(vis_msg));
+	}
+	if (base_color != workpiece.base_color) {
+		msgs::Visual vis_msg;
+		vis_msg.set_parent_name(workpiece.name + "::cylinder");
+		vis_msg.set_name(workpiece.name + "::cylinder::cylinder_visual");
+		set_color(vis_msg, base_color);
+		queue_visual(std::move(vis_msg));
+	}
+	workpiece.base_color = base_color;
+	workpiece.have_cap   = false;
+	workpiece.cap_color  = gazsim_msgs::Color::NONE;
+	unannounced_.push_back(workpiece.name);
+}
+
+void
+WorkpieceManager::publish_result(const WorkpieceState &workpiece, gazsim_msgs::Color clr)
+{
+	gazsim_msgs::WorkpieceResult msg;
+	msg.set_puck_name(workpiece.name);
+	msg.set_color(clr);
+	result_pub_->Publish(msg);
+}
+
+msgs::Visual
+WorkpieceManager::create_visual_msg(WorkpieceState &   workpiece,
+                                    const std::string &element_name,
+                                    double             element_height,
+                                    gazsim_msgs::Color clr)
+{
+	// create a massage for visual control
+	gazebo::msgs::Visual visual_msg;
+	// the parent of the new visual is the workpiece itself
+	visual_msg.set_parent_name(workpiece.name + "::cylinder");
+	// set the name of the object
+	visual_msg.set_name(workpiece.name + "::cylinder::" + element_name);
+	// no need for shadows on the visual
+	visual_msg.set_cast_shadows(false);
+	// the visual may have been hidden before the workpiece was recycled
+	visual_msg.set_visible(true);
+	// get  a geometryfor the visual
+	gazebo::msgs::Geometry *geom_msg = visual_msg.mutable_geometry();
+	// the geomery is roughly a cylinder
+	geom_msg->set_type(msgs::Geometry::CYLINDER);
+	// this model is a cylinder, so the x and y params of its bounding box
+	// should be equal, the double radius. so set the radius of the addition
+	// according to it. The bounding box is only computed once per workpiece.
+	if (workpiece.radius <= 0) {
+		physics::ModelPtr model = workpiece.model.lock();
+		if (model) {
+#if GAZEBO_MAJOR_VERSION >= 8
+			workpiece.radius = model->BoundingBox().XLength() / 2;
+#else
+			workpiece.radius = model->GetBoundingBox().GetXLength() / 2;
+#endif
+		}
+	}
+	geom_msg->mutable_cylinder()->set_radius(workpiece.radius);
+
+	// calcualte the height for the next ring
+	double vis_middle = (workpiece_height_ / 2) + workpiece.ring_colors.size() * ring_height_
+	                    + (element_height / 2);
+	// the height of a ring, in meters
+	geom_msg->mutable_cylinder()->set_length(element_height);
+	//set the color according to the message
+	set_color(visual_msg, clr);
+	// set the calculated pose for the visual
+#if GAZEBO_MAJOR_VERSION > 5
+	msgs::Set(visual_msg.mutable_pose(), ignition::math::Pose3d(0, 0, vis_middle, 0, 0, 0));
+#else
+	msgs::Set(visual_msg.mutable_pose(), math::Pose(0, 0, vis_middle, 0, 0, 0));
+#endif
+	return visual_msg;
+}
+
+void
+WorkpieceManager::deliver(const WorkpieceState &workpiece, gazsim_msgs::Team team)
+{
+	const std::vector<gazsim_msgs::Color> &ring_colors = workpiece.ring_colors;
+	std::string                            ring_string = "";
+	for (size_t i = 0; i < ring_colors.size(); i++) {
+		ring_string += gazsim_msgs::Color_Name(ring_colors[i]) + ", ";
+	}
+	printf("delivering a %s base with %zu rings, colored %s and a %s cap\n",
+	       gazsim_msgs::Color_Name(workpiece.base_color).c_str(),
+	       ring_colors.size(),
+	       ring_string.c_str(),
+	       gazsim_msgs::Color_Name(workpiece.cap_color).c_str());
+	llsf_msgs::SetOrderDeliveredByColor delivery_msg;
+	switch (team) {
+	case gazsim_msgs::Team::CYAN: delivery_msg.set_team_color(llsf_msgs::Team::CYAN); break;
+	case gazsim_msgs::Team::MAGENTA: delivery_msg.set_team_color(llsf_msgs::Team::MAGENTA); break;
+	}
+	switch (workpiece.base_color) {
+	case gazsim_msgs::Color::RED: delivery_msg.set_base_color(llsf_msgs::BaseColor::BASE_RED); break;
+	case gazsim_msgs::Color::BLACK:
+		delivery_msg.set_base_color(llsf_msgs::BaseColor::BASE_BLACK);
+		break;
+	case gazsim_msgs::Color::SILVER: delivery_msg.set_base_color(llsf_msgs::BaseColor::BASE_SILVER);
+	default: break;
+	}
+	for (size_t i = 0; i < ring_colors.size(); i++) {
+		switch (ring_colors[i]) {
+		case gazsim_msgs::Color::GREEN:
+			delivery_msg.add_ring_colors(llsf_msgs::RingColor::RING_GREEN);
+			break;
+		case gazsim_msgs::Color::BLUE:
+			delivery_msg.add_ring_colors(llsf_msgs::RingColor::RING_BLUE);
+			break;
+		case gazsim_msgs::Color::YELLOW:
+			delivery_msg.add_ring_colors(llsf_msgs::RingColor::RING_YELLOW);
+			break;
+		case gazsim_msgs::Color::ORANGE:
+			delivery_msg.add_ring_colors(llsf_msgs::RingColor::RING_ORANGE);
+			break;
+		default: break;
+		}
+	}
+	if (workpiece.have_cap) {
+		switch (workpiece.cap_color) {
+		case gazsim_msgs::Color::GREY: delivery_msg.set_cap_color(llsf_msgs::CapColor::CAP_GREY); break;
+		case gazsim_msgs::Color::BLACK:
+			delivery_msg.set_cap_color(llsf_msgs::CapColor::CAP_BLACK);
+			break;
+		default: break;
+		}
+	}
+	delivery_pub_->Publish(delivery_msg);
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *  workpiece_manager.h - Command routing and visuals of all workpieces
+ *
+ *  Created:   Sun 18 Oct 21:03:52 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <configurable/configurable.h>
+#include <gazsim_msgs/WorkpieceCommand.pb.h>
+#include <llsf_msgs/OrderInfo.pb.h>
+#include <utils/misc/workpiece_journal.h>
+
+#include <boost/weak_ptr.hpp>
+#include <gazebo/common/common.hh>
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef const boost::shared_ptr<gazsim_msgs::WorkpieceCommand const> ConstWorkpieceCommandPtr;
+
+namespace gazebo {
+
+/** State of a single workpiece. */
+struct WorkpieceState
+{
+	std::string                     name;
+	boost::weak_ptr<physics::Model> model;
+	gazsim_msgs::Color              base_color;
+	std::vector<gazsim_msgs::Color> ring_colors;
+	bool                            have_cap;
+	gazsim_msgs::Color              cap_color;
+	/// number of consecutive steps the workpiece did not move
+	unsigned int resting_steps;
+	/// radius of the base, 0 until it is read from the model
+	double radius;
+};
+
+/** Manager of all workpieces of a world.
+ * There is one manager per world. It owns the transport endpoints of the
+ * workpieces and keeps the state of each of them, the puck plugin only
+ * registers its model. Workpiece commands are received once and routed to
+ * the addressed workpiece by name, instead of being parsed by every puck.
+ * Workpieces at rest for a number of steps are frozen by disabling their
+ * physics. They are woken by the physics engine on contact or when a joint
+ * attaches them, and by anyone enabling the model again, e.g. a station
+ * moving the workpiece.
+ */
+class WorkpieceManager : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	static std::shared_ptr<WorkpieceManager> instance(physics::WorldPtr world);
+	~WorkpieceManager();
+
+	void add_workpiece(physics::ModelPtr model, gazsim_msgs::Color base_color);
+	void remove_workpiece(const std::string &name);
+
+private:
+	explicit WorkpieceManager(physics::WorldPtr world);
+	void on_update();
+	void freeze_resting();
+	void queue_visual(msgs::Visual &&visual);
+	void journal(gazebo_rcll::JournalEvent event, const WorkpieceState &workpiece, uint16_t value);
+	void on_command_msg(ConstWorkpieceCommandPtr &cmd);
+
+	void add_ring(WorkpieceState &workpiece, gazsim_msgs::Color clr);
+	void add_cap(WorkpieceState &workpiece, gazsim_msgs::Color clr);
+	void remove_cap(WorkpieceState &workpiece);
+	void deliver(const WorkpieceState &workpiece, gazsim_msgs::Team team);
+	void reset(WorkpieceState &workpiece, gazsim_msgs::Color base_color);
+	void publish_result(const WorkpieceState &workpiece, gazsim_msgs::Color clr);
+
+	msgs::Visual create_visual_msg(WorkpieceState &   workpiece,
+	                               const std::string &element_name,
+	                               double             element_height,
+	                               gazsim_msgs::Color clr);
+
+	physics::WorldPtr    world_;
+	event::ConnectionPtr update_connection_;
+
+	transport::NodePtr       node_;
+	transport::SubscriberPtr command_sub_;
+	transport::PublisherPtr  new_puck_pub_;
+	transport::PublisherPtr  visual_pub_;
+	transport::PublisherPtr  result_pub_;
+	transport::PublisherPtr  delivery_pub_;
+
+	/// Lifecycle journal of the workpieces, nullptr if disabled
+	std::shared_ptr<gazebo_rcll::WorkpieceJournal> journal_;
+
+	/// The height of one ring
+	float ring_height_;
+	/// The height of one cap
+	float cap_height_;
+	/// The height of the workpiece base
+	float workpiece_height_;
+	/// Number of steps a workpiece must rest to be frozen, 0 to never freeze
+	unsigned int freeze_rest_steps_;
+	/// Max linear and angular velocity of a workpiece at rest
+	double freeze_linear_velocity_;
+	double freeze_angular_velocity_;
+
+	std::mutex                                                       mutex_;
+	std::unordered_map<std::string, std::unique_ptr<WorkpieceState>> workpieces_;
+	/// workpieces to announce on ~/new_puck with the next update
+	std::vector<std::string> unannounced_;
+	/// visual changes to publish with the next update, at most one per visual
+	std::vector<msgs::Visual>                    pending_visuals_;
+	std::unordered_map<std::string, std::size_t> pending_visual_index_;
+};
+
+} // namespace gazebo
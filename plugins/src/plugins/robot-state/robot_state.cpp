@@ -0,0 +1,110 @@
+/***************************************************************************
+ *  robot_state.cpp - Publishes the fused sensor state of a robot
+ *
+ *  Created:   Mon 19 Oct 00:31:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "robot_state.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <boost/bind.hpp>
+
+using namespace gazebo;
+
+// Register this plugin to make it available in the simulator
+GZ_REGISTER_MODEL_PLUGIN(RobotStatePublisher)
+
+RobotStatePublisher::RobotStatePublisher()
+{
+}
+
+RobotStatePublisher::~RobotStatePublisher()
+{
+	printf("Destructing RobotState Plugin!\n");
+}
+
+/** on loading of the plugin
+ * @param _parent Parent Model
+ */
+void
+RobotStatePublisher::Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/)
+{
+	model_ = _parent;
+	name_  = model_->GetName();
+	printf("Loading RobotState Plugin of model %s\n", name_.c_str());
+
+	hub_            = RobotStateHub::instance(model_);
+	send_interval_  = config->get_float("plugins/robot-state/send-interval");
+	last_sent_time_ = model_->GetWorld()->GZWRAP_SIM_TIME().Double();
+
+	node_ = transport::NodePtr(new transport::Node());
+	// the namespace is set to the model name!
+	node_->Init(model_->GetWorld()->GZWRAP_NAME() + "/" + name_);
+	state_pub_ =
+	  node_->Advertise<gazsim_msgs::RobotState>(config->get_string("plugins/robot-state/topic"));
+
+	update_connection_ = event::Events::ConnectWorldUpdateBegin(
+	  boost::bind(&RobotStatePublisher::OnUpdate, this, _1));
+}
+
+/** Called by the world update start event
+ */
+void
+RobotStatePublisher::OnUpdate(const common::UpdateInfo & /*_info*/)
+{
+	common::Time sim_time = model_->GetWorld()->GZWRAP_SIM_TIME();
+	if (sim_time.Double() - last_sent_time_ > send_interval_) {
+		last_sent_time_ = sim_time.Double();
+		send_state(sim_time);
+	}
+}
+
+/** on Gazebo reset
+ */
+void
+RobotStatePublisher::Reset()
+{
+}
+
+/** Sample the state of the robot and publish it.
+ * @param sim_time the current simulation time
+ */
+void
+RobotStatePublisher::send_state(const common::Time &sim_time)
+{
+	if (!state_pub_->HasConnections()) {
+		return;
+	}
+	const gzwrap::Pose3d pose = model_->GZWRAP_WORLD_POSE();
+
+	gazsim_msgs::RobotState msg;
+	msg.set_sim_time_sec(sim_time.sec);
+	msg.set_sim_time_nsec(sim_time.nsec);
+	msg.set_pose_x(pose.GZWRAP_POS_X);
+	msg.set_pose_y(pose.GZWRAP_POS_Y);
+	msg.set_pose_z(pose.GZWRAP_POS_Z);
+	msg.set_pose_ori_x(pose.GZWRAP_ROT_X);
+	msg.set_pose_ori_y(pose.GZWRAP_ROT_Y);
+	msg.set_pose_ori_z(pose.GZWRAP_ROT_Z);
+	msg.set_pose_ori_w(pose.GZWRAP_ROT_W);
+	msg.set_roll(pose.GZWRAP_ROT_EULER_X);
+	msg.set_pitch(pose.GZWRAP_ROT_EULER_Y);
+	msg.set_yaw(pose.GZWRAP_ROT_EULER_Z);
+	hub_->fill(msg);
+
+	state_pub_->Publish(msg);
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+ *  robot_state.h - Publishes the fused sensor state of a robot
+ *
+ *  Created:   Mon 19 Oct 00:31:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include "robot_state_hub.h"
+
+#include <configurable/configurable.h>
+
+#include <gazebo/common/common.hh>
+#include <gazebo/gazebo.hh>
+#include <gazebo/physics/physics.hh>
+#include <gazebo/transport/transport.hh>
+#include <memory>
+#include <string>
+
+namespace gazebo {
+
+/** Publisher of the fused state of a robot.
+ * Once per send interval, the pose of the robot is read once and published
+ * together with its gyro angles and the values reported by its odometry and
+ * gripper plugins as a single gazsim_msgs::RobotState. Nothing is read if
+ * nobody subscribed, the separate topics stay available.
+ */
+class RobotStatePublisher : public ModelPlugin, public gazebo_rcll::ConfigurableAspect
+{
+public:
+	RobotStatePublisher();
+	~RobotStatePublisher();
+
+	virtual void Load(physics::ModelPtr _parent, sdf::ElementPtr /*_sdf*/);
+	virtual void OnUpdate(const common::UpdateInfo &);
+	virtual void Reset();
+
+private:
+	void send_state(const common::Time &sim_time);
+
+	physics::ModelPtr    model_;
+	event::ConnectionPtr update_connection_;
+	std::string          name_;
+
+	transport::NodePtr      node_;
+	transport::PublisherPtr state_pub_;
+
+	/// Values reported by the other plugins of the robot
+	std::shared_ptr<RobotStateHub> hub_;
+
+	double last_sent_time_;
+	double send_interval_;
+};
+
+} // namespace gazebo
@@ -0,0 +1,100 @@
+/***************************************************************************
+ *  robot_state_hub.cpp - Sensor values reported for the fused robot state
+ *
+ *  Created:   Mon 19 Oct 00:31:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include "robot_state_hub.h"
+
+#include <utils/misc/gazebo_api_wrappers.h>
+
+#include <map>
+
+using namespace gazebo;
+
+/** Get the hub of a robot.
+ * @param robot the model of the robot, not of a nested model like its gripper
+ * @return the hub of the given robot
+ */
+std::shared_ptr<RobotStateHub>
+RobotStateHub::instance(physics::ModelPtr robot)
+{
+	static std::mutex                                           instances_mutex;
+	static std::map<std::string, std::weak_ptr<RobotStateHub>> instances;
+
+	const std::string name = robot->GetWorld()->GZWRAP_NAME() + "/" + robot->GetScopedName();
+
+	std::lock_guard<std::mutex>    lock{instances_mutex};
+	std::shared_ptr<RobotStateHub> hub = instances[name].lock();
+	if (!hub) {
+		hub             = std::shared_ptr<RobotStateHub>(new RobotStateHub());
+		instances[name] = hub;
+	}
+	return hub;
+}
+
+RobotStateHub::RobotStateHub()
+: have_odometry_(false),
+  odometry_x_(0),
+  odometry_y_(0),
+  odometry_ori_(0),
+  have_gripper_(false),
+  has_puck_(false)
+{
+}
+
+/** Report the odometry estimate.
+ * @param x the estimated x position
+ * @param y the estimated y position
+ * @param ori the estimated orientation
+ */
+void
+RobotStateHub::set_odometry(float x, float y, float ori)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	have_odometry_ = true;
+	odometry_x_    = x;
+	odometry_y_    = y;
+	odometry_ori_  = ori;
+}
+
+/** Report whether the gripper holds a workpiece.
+ * @param has_puck true if the gripper holds a workpiece
+ */
+void
+RobotStateHub::set_has_puck(bool has_puck)
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	have_gripper_ = true;
+	has_puck_     = has_puck;
+}
+
+/** Add the reported values to a robot state.
+ * @param msg the message to fill
+ */
+void
+RobotStateHub::fill(gazsim_msgs::RobotState &msg) const
+{
+	std::lock_guard<std::mutex> lock{mutex_};
+	if (have_odometry_) {
+		msg.set_odometry_x(odometry_x_);
+		msg.set_odometry_y(odometry_y_);
+		msg.set_odometry_ori(odometry_ori_);
+	}
+	if (have_gripper_) {
+		msg.set_has_puck(has_puck_);
+	}
+}
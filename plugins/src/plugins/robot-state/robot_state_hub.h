@@ -0,0 +1,56 @@
+/***************************************************************************
+ *  robot_state_hub.h - Sensor values reported for the fused robot state
+ *
+ *  Created:   Mon 19 Oct 00:31:08 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#pragma once
+
+#include <gazsim_msgs/RobotState.pb.h>
+
+#include <gazebo/physics/physics.hh>
+#include <memory>
+#include <mutex>
+
+namespace gazebo {
+
+/** Collector of the sensor values of one robot which are not part of its pose.
+ * The odometry and gripper plugins of a robot report their values here, the
+ * robot state publisher adds them to the fused state of the robot. A robot
+ * without such a plugin simply has no values to add.
+ */
+class RobotStateHub
+{
+public:
+	static std::shared_ptr<RobotStateHub> instance(physics::ModelPtr robot);
+
+	void set_odometry(float x, float y, float ori);
+	void set_has_puck(bool has_puck);
+	void fill(gazsim_msgs::RobotState &msg) const;
+
+private:
+	RobotStateHub();
+
+	mutable std::mutex mutex_;
+	bool               have_odometry_;
+	float              odometry_x_;
+	float              odometry_y_;
+	float              odometry_ori_;
+	bool               have_gripper_;
+	bool               has_puck_;
+};
+
+} // namespace gazebo
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *  gazebo_rcll_ports.cpp - Print the ports of a simulation instance
+ *
+ *  Created:   Sun 18 Oct 16:40:02 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <configurable/configurable.h>
+#include <core/exception.h>
+#include <utils/llsf/instance_ports.h>
+#include <utils/llsf/machine_registry.h>
+#include <utils/system/argparser.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/// Port of the gazebo master of instance 0
+#define GAZEBO_MASTER_PORT 11345
+
+/** Prints the ports used by one simulation instance. */
+class InstancePorts : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	void
+	print()
+	{
+		unsigned int stride    = config->get_uint("plugins/instance/port-stride");
+		unsigned int port_base = llsf_utils::instance_port(
+		  config->get_uint("plugins/instance/opcua-port-base"), stride);
+
+		printf("GAZEBO_RCLL_INSTANCE=%u\n", llsf_utils::instance_number());
+		printf("GAZEBO_MASTER_URI=http://localhost:%u\n",
+		       llsf_utils::instance_port(GAZEBO_MASTER_PORT, stride));
+		printf("REFBOX_PORT=%u\n",
+		       llsf_utils::instance_port(config->get_uint("plugins/llsf-refbox-comm/refbox-port"),
+		                                 stride));
+		printf("OPCUA_SHARED_PORT=%u\n", port_base + llsf_utils::SHARED_PORT_OFFSET);
+		for (const llsf_utils::MachineInfo &machine : llsf_utils::machines) {
+			std::string var = machine.name;
+			var.replace(1, 1, "_");
+			printf("OPCUA_%s_PORT=%u\n", var.c_str(), port_base + machine.port_offset);
+		}
+	}
+};
+
+static void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-h] [-i INSTANCE]\n"
+	       " -h           Show this help message\n"
+	       " -i INSTANCE  Print the ports of the given instance, defaults to\n"
+	       "              $" GAZEBO_RCLL_INSTANCE_ENV " or 0\n"
+	       "\n"
+	       "The output can be sourced by a launcher, e.g.\n"
+	       "  eval $(%s -i 1) && export GAZEBO_MASTER_URI GAZEBO_RCLL_INSTANCE\n",
+	       program_name,
+	       program_name);
+}
+
+int
+main(int argc, char **argv)
+{
+	try {
+		fawkes::ArgumentParser argp(argc, argv, "hi:");
+		if (argp.has_arg("h")) {
+			print_usage(argp.program_name());
+			return 0;
+		}
+		if (argp.has_arg("i")) {
+			setenv(GAZEBO_RCLL_INSTANCE_ENV, std::to_string(argp.parse_int("i")).c_str(), 1);
+		}
+		InstancePorts().print();
+	} catch (fawkes::Exception &e) {
+		fprintf(stderr, "%s\n", e.what());
+		print_usage(argv[0]);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,390 @@
+/***************************************************************************
+ *  mps_bench.cpp - Load generator for the OPC UA command path of the MPS
+ *
+ *  Created:   Sun 18 Oct 17:25:31 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <configurable/configurable.h>
+#include <core/exception.h>
+#include <opc/ua/client/client.h>
+#include <opc/ua/node.h>
+#include <opc/ua/subscription.h>
+#include <utils/llsf/instance_ports.h>
+#include <utils/system/argparser.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+/** A command written to the In register block of a station. */
+struct BenchCommand
+{
+	uint16_t action_id;
+	uint16_t payload1;
+	uint16_t payload2;
+};
+
+/** Get the type of a station from its name, e.g. RS for C-RS1.
+ * @param name the name of the station
+ * @return the type of the station
+ */
+static std::string
+station_type(const std::string &name)
+{
+	return name.substr(2, 2);
+}
+
+/** Get the default command sent to a station.
+ * The commands are chosen such that the station reacts to them without a
+ * workpiece: the ring station resets the command and all other stations move
+ * their empty conveyor, which only keeps them busy for the move duration.
+ * None of them spawns a workpiece, so a long run does not fill the world.
+ * @param type the type of the station
+ * @return the command to send
+ */
+static BenchCommand
+default_command(const std::string &type)
+{
+	if (type == "BS")
+		return BenchCommand{102, 3, 0};
+	if (type == "RS")
+		return BenchCommand{203, 1, 1};
+	if (type == "CS")
+		return BenchCommand{302, 3, 0};
+	if (type == "DS")
+		return BenchCommand{402, 3, 0};
+	return BenchCommand{502, 3, 0};
+}
+
+/** Drives one station with commands and measures its reaction time.
+ * Commands are sent in a closed loop limited to the given rate: the next
+ * command is only written once the station reacted to the previous one or
+ * the command timed out, the command was cleared again and the station is
+ * no longer busy, as it holds further commands until its operation is done.
+ * The reaction is the station setting the Busy register or resetting the
+ * ActionId register, which covers the subscription, the command queue and
+ * the station's process_command_in().
+ */
+class StationLoad : public OpcUa::SubscriptionHandler
+{
+public:
+	StationLoad(const std::string &station_name, const std::string &endpoint, bool shared)
+	: name(station_name),
+	  sent(0),
+	  timeouts(0),
+	  elapsed(0),
+	  endpoint_(endpoint),
+	  shared_(shared),
+	  phase_(IDLE),
+	  busy_(false)
+	{
+	}
+
+	void
+	run(const BenchCommand &cmd, double rate, double duration, unsigned int timeout_ms)
+	{
+		OpcUa::UaClient client;
+		client.Connect(endpoint_);
+
+		std::vector<std::string> path;
+		if (shared_) {
+			path.push_back("2:" + name);
+		}
+		for (const char *elem : {"2:DeviceSet",
+		                         "4:CPX-E-CEC-C1-PN",
+		                         "4:Resources",
+		                         "4:Application",
+		                         "3:GlobalVars",
+		                         "4:G",
+		                         "4:In",
+		                         "4:p"}) {
+			path.push_back(elem);
+		}
+		OpcUa::Node p         = client.GetObjectsNode().GetChild(path);
+		OpcUa::Node action_id = p.GetChild("4:ActionId");
+		OpcUa::Node payload1  = p.GetChild(std::vector<std::string>{"4:Data", "0:Payload1"});
+		OpcUa::Node payload2  = p.GetChild(std::vector<std::string>{"4:Data", "1:Payload2"});
+		OpcUa::Node busy      = p.GetChild(std::vector<std::string>{"4:Status", "4:Busy"});
+
+		OpcUa::Subscription::SharedPtr sub = client.CreateSubscription(1, *this);
+		handle_action_id_                   = sub->SubscribeDataChange(action_id);
+		handle_busy_                        = sub->SubscribeDataChange(busy);
+
+		const std::chrono::milliseconds timeout(timeout_ms);
+		// the longest operation takes 3.5 s of simulation time
+		const std::chrono::seconds      idle_timeout(10);
+		const Clock::duration           period = std::chrono::duration_cast<Clock::duration>(
+		  std::chrono::duration<double>(rate > 0 ? 1. / rate : 0.));
+		const Clock::time_point start = Clock::now();
+		const Clock::time_point end   = start
+		                              + std::chrono::duration_cast<Clock::duration>(
+		                                std::chrono::duration<double>(duration));
+		Clock::time_point next = start;
+		while (Clock::now() < end) {
+			std::this_thread::sleep_until(next);
+			next += period;
+
+			payload1.SetValue(OpcUa::Variant(cmd.payload1));
+			payload2.SetValue(OpcUa::Variant(cmd.payload2));
+			std::unique_lock<std::mutex> lock{mutex_};
+			phase_   = SENT;
+			sent_at_ = Clock::now();
+			lock.unlock();
+			action_id.SetValue(OpcUa::Variant(cmd.action_id));
+			++sent;
+
+			lock.lock();
+			if (!phase_cv_.wait_for(lock, timeout, [this] { return phase_ != SENT; })) {
+				++timeouts;
+			}
+			if (phase_ == RESET) {
+				// The station already reset the command.
+				phase_ = IDLE;
+				continue;
+			}
+			// Clear the command, the station only handles changes of the action id.
+			phase_ = CLEARING;
+			lock.unlock();
+			action_id.SetValue(OpcUa::Variant(uint16_t(0)));
+			lock.lock();
+			phase_cv_.wait_for(lock, timeout, [this] { return phase_ == IDLE; });
+			phase_ = IDLE;
+			phase_cv_.wait_for(lock, idle_timeout, [this] { return !busy_; });
+		}
+		elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+		sub->Delete();
+		client.Disconnect();
+	}
+
+	void
+	DataChange(uint32_t handle, const OpcUa::Node &, const OpcUa::Variant &val, OpcUa::AttributeId)
+	  override
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (handle == handle_busy_) {
+			busy_ = bool(val);
+		}
+		if (handle == handle_busy_ && busy_ && phase_ == SENT) {
+			latencies.push_back(
+			  std::chrono::duration<double, std::milli>(Clock::now() - sent_at_).count());
+			phase_ = REACTED;
+		} else if (handle == handle_action_id_ && uint16_t(val) == 0) {
+			if (phase_ == SENT) {
+				latencies.push_back(
+				  std::chrono::duration<double, std::milli>(Clock::now() - sent_at_).count());
+				phase_ = RESET;
+			} else if (phase_ == CLEARING) {
+				phase_ = IDLE;
+			}
+		}
+		phase_cv_.notify_all();
+	}
+
+	std::string         name;
+	unsigned int        sent;
+	unsigned int        timeouts;
+	double              elapsed;
+	std::vector<double> latencies;
+
+private:
+	/// Where the current command is in its round trip
+	enum Phase {
+		IDLE,     ///< no command pending
+		SENT,     ///< written, waiting for the station's reaction
+		REACTED,  ///< the station set the Busy register
+		RESET,    ///< the station reset the ActionId register
+		CLEARING, ///< waiting for the notification of clearing the command
+	};
+
+	std::string             endpoint_;
+	bool                    shared_;
+	std::mutex              mutex_;
+	std::condition_variable phase_cv_;
+	Phase                   phase_;
+	bool                    busy_;
+	Clock::time_point       sent_at_;
+	uint32_t                handle_action_id_;
+	uint32_t                handle_busy_;
+};
+
+/** Get a percentile of sorted samples with the nearest-rank method.
+ * @param sorted the sorted samples
+ * @param p the percentile in [0, 1]
+ * @return the percentile, 0 if there are no samples
+ */
+static double
+percentile(const std::vector<double> &sorted, double p)
+{
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t rank = std::max<size_t>(1, size_t(p * sorted.size() + 0.5));
+	return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+/** Reads the endpoints of the stations from the configuration. */
+class BenchConfig : public gazebo_rcll::ConfigurableAspect
+{
+public:
+	unsigned int
+	port_base()
+	{
+		return llsf_utils::instance_port(config->get_uint("plugins/instance/opcua-port-base"),
+		                                 config->get_uint("plugins/instance/port-stride"));
+	}
+};
+
+static void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-h] [-s STATIONS] [-r RATE] [-d DURATION] [-t TIMEOUT] [-i INSTANCE]"
+	       " [-S]\n"
+	       " -h           Show this help message\n"
+	       " -s STATIONS  Comma-separated stations to drive, default C-BS,C-CS1,C-RS1,C-DS\n"
+	       " -r RATE      Commands per second and station, 0 for as fast as possible,\n"
+	       "              default 10\n"
+	       " -d DURATION  Duration of the run in seconds, default 30\n"
+	       " -t TIMEOUT   Time to wait for a reaction of the station in ms, default 1000\n"
+	       " -i INSTANCE  Simulation instance to connect to, defaults to\n"
+	       "              $" GAZEBO_RCLL_INSTANCE_ENV " or 0\n"
+	       " -S           Connect to the server shared by all stations\n"
+	       "\n"
+	       "Start the simulation first, e.g. with\n"
+	       "  gzserver worlds/carologistics/mps-bench.world\n",
+	       program_name);
+}
+
+int
+main(int argc, char **argv)
+{
+	std::string  stations   = "C-BS,C-CS1,C-RS1,C-DS";
+	double       rate       = 10;
+	double       duration   = 30;
+	unsigned int timeout_ms = 1000;
+	bool         shared     = false;
+	try {
+		fawkes::ArgumentParser argp(argc, argv, "hs:r:d:t:i:S");
+		if (argp.has_arg("h")) {
+			print_usage(argp.program_name());
+			return 0;
+		}
+		if (argp.has_arg("s"))
+			stations = argp.arg("s");
+		if (argp.has_arg("r"))
+			rate = argp.parse_float("r");
+		if (argp.has_arg("d"))
+			duration = argp.parse_float("d");
+		if (argp.has_arg("t"))
+			timeout_ms = argp.parse_int("t");
+		if (argp.has_arg("i"))
+			setenv(GAZEBO_RCLL_INSTANCE_ENV, std::to_string(argp.parse_int("i")).c_str(), 1);
+		shared = argp.has_arg("S");
+	} catch (fawkes::Exception &e) {
+		fprintf(stderr, "%s\n", e.what());
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	unsigned int                              port_base = BenchConfig().port_base();
+	std::vector<std::unique_ptr<StationLoad>> loads;
+	std::istringstream                        station_list(stations);
+	std::string                               name;
+	while (std::getline(station_list, name, ',')) {
+		int offset = llsf_utils::station_port_offset(name);
+		if (offset < 0) {
+			fprintf(stderr, "Unknown station %s\n", name.c_str());
+			return 1;
+		}
+		unsigned int port = port_base + (shared ? llsf_utils::SHARED_PORT_OFFSET : offset);
+		loads.emplace_back(new StationLoad(name,
+		                                   "opc.tcp://localhost:" + std::to_string(port) + "/",
+		                                   shared));
+	}
+
+	std::vector<std::thread> threads;
+	for (auto &load : loads) {
+		StationLoad *l = load.get();
+		threads.emplace_back([l, rate, duration, timeout_ms] {
+			try {
+				l->run(default_command(station_type(l->name)), rate, duration, timeout_ms);
+			} catch (std::exception &e) {
+				fprintf(stderr, "%s: %s\n", l->name.c_str(), e.what());
+			}
+		});
+	}
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	// Aggregate the results per station type.
+	struct TypeResult
+	{
+		unsigned int        stations = 0;
+		unsigned int        sent     = 0;
+		unsigned int        timeouts = 0;
+		double              rate     = 0;
+		std::vector<double> latencies;
+	};
+	std::map<std::string, TypeResult> results;
+	for (auto &load : loads) {
+		TypeResult &r = results[station_type(load->name)];
+		r.stations++;
+		r.sent += load->sent;
+		r.timeouts += load->timeouts;
+		if (load->elapsed > 0) {
+			r.rate += load->latencies.size() / load->elapsed;
+		}
+		r.latencies.insert(r.latencies.end(), load->latencies.begin(), load->latencies.end());
+	}
+
+	printf("%-4s %8s %8s %8s %10s %9s %9s %9s %9s\n",
+	       "type",
+	       "stations",
+	       "sent",
+	       "timeouts",
+	       "cmd/s",
+	       "p50 ms",
+	       "p90 ms",
+	       "p99 ms",
+	       "max ms");
+	for (auto &entry : results) {
+		TypeResult &r = entry.second;
+		std::sort(r.latencies.begin(), r.latencies.end());
+		printf("%-4s %8u %8u %8u %10.1f %9.2f %9.2f %9.2f %9.2f\n",
+		       entry.first.c_str(),
+		       r.stations,
+		       r.sent,
+		       r.timeouts,
+		       r.rate,
+		       percentile(r.latencies, 0.5),
+		       percentile(r.latencies, 0.9),
+		       percentile(r.latencies, 0.99),
+		       r.latencies.empty() ? 0. : r.latencies.back());
+	}
+	return 0;
+}
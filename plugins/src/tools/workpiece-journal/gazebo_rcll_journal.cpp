@@ -0,0 +1,347 @@
+/***************************************************************************
+ *  gazebo_rcll_journal.cpp - Lead time statistics from a workpiece journal
+ *
+ *  Created:   Sun 18 Oct 23:02:47 CEST 2026
+ *  Copyright  2026  The gazebo-rcll contributors
+ ****************************************************************************/
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.md file.
+ */
+
+#include <core/exception.h>
+#include <gazsim_msgs/WorkpieceCommand.pb.h>
+#include <utils/misc/workpiece_journal.h>
+#include <utils/system/argparser.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using gazebo_rcll::JournalEvent;
+using gazebo_rcll::JournalHeader;
+using gazebo_rcll::JournalRecord;
+
+/** A journal record copied out of the file. */
+struct Event
+{
+	double       sim_time;
+	JournalEvent event;
+	uint16_t     value;
+	std::string  workpiece;
+	std::string  subject;
+};
+
+/** The life of one workpiece from its spawn until it is delivered or recycled.
+ * A recycled workpiece model starts a new product when it is spawned again.
+ */
+struct Product
+{
+	std::string           workpiece;
+	std::string           origin;
+	uint16_t              base_color;
+	std::vector<uint16_t> ring_colors;
+	bool                  have_cap;
+	uint16_t              cap_color;
+	double                spawn_time;
+	double                end_time;
+	/// time the product spent in a gripper
+	double held_time;
+	/// start of the current grip, negative if not held
+	double held_since;
+	bool   delivered;
+};
+
+static std::string
+color_name(uint16_t color)
+{
+	return gazsim_msgs::Color_IsValid(color) ? gazsim_msgs::Color_Name(gazsim_msgs::Color(color))
+	                                         : std::to_string(color);
+}
+
+/** Read all complete records of a journal file.
+ * @param path the journal file
+ * @param events the records, ordered by simulation time
+ * @param dropped set to the number of events the writers had to drop
+ */
+static void
+read_journal(const char *path, std::vector<Event> &events, uint64_t &dropped)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		throw fawkes::Exception(errno, "Cannot open journal %s", path);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(JournalHeader)) {
+		close(fd);
+		throw fawkes::Exception("%s is not a workpiece journal", path);
+	}
+	void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		throw fawkes::Exception(errno, "Cannot map journal %s", path);
+	}
+	const JournalHeader *header = static_cast<const JournalHeader *>(mapping);
+	if (memcmp(header->magic, gazebo_rcll::WorkpieceJournal::MAGIC, sizeof(header->magic)) != 0
+	    || header->version != gazebo_rcll::WorkpieceJournal::VERSION
+	    || header->record_size != sizeof(JournalRecord)) {
+		munmap(mapping, st.st_size);
+		throw fawkes::Exception("%s is not a workpiece journal of this version", path);
+	}
+	// a journal which is still written may be larger than the file was when it was mapped
+	uint64_t mapped = (st.st_size - sizeof(JournalHeader)) / sizeof(JournalRecord);
+	uint64_t count  = std::min(std::min(header->next.load(), header->capacity), mapped);
+	dropped         = header->dropped.load();
+
+	const JournalRecord *records = reinterpret_cast<const JournalRecord *>(header + 1);
+	for (uint64_t i = 0; i < count; i++) {
+		const JournalRecord &record = records[i];
+		JournalEvent         event  = JournalEvent(record.event.load(std::memory_order_acquire));
+		if (event == JournalEvent::NONE) {
+			continue;
+		}
+		events.push_back(Event{record.sim_time,
+		                       event,
+		                       record.value,
+		                       std::string(record.workpiece,
+		                                   strnlen(record.workpiece, sizeof(record.workpiece))),
+		                       std::string(record.subject,
+		                                   strnlen(record.subject, sizeof(record.subject)))});
+	}
+	munmap(mapping, st.st_size);
+	// writers claim records in order, but may fill them in a different order
+	std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+		return a.sim_time < b.sim_time;
+	});
+}
+
+/** Start a new product, finish the previous one of the same workpiece.
+ * @param active the products currently in the game, by workpiece
+ * @param products the finished products
+ * @param event the first event of the new product
+ * @return the new product
+ */
+static Product *
+start_product(std::map<std::string, Product> &active,
+              std::vector<Product> &          products,
+              const Event &                   event)
+{
+	auto previous = active.find(event.workpiece);
+	if (previous != active.end()) {
+		previous->second.end_time = event.sim_time;
+		products.push_back(previous->second);
+	}
+	Product &product   = active[event.workpiece];
+	product            = Product{};
+	product.workpiece  = event.workpiece;
+	product.cap_color  = gazsim_msgs::Color::NONE;
+	product.spawn_time = event.sim_time;
+	product.held_since = -1;
+	return &product;
+}
+
+/** Replay the events and split them into products.
+ * @param events the events ordered by time
+ * @param products the finished products, i.e. delivered or recycled
+ * @param unfinished the products still in the game at the end of the journal
+ */
+static void
+replay(const std::vector<Event> &events,
+       std::vector<Product> &    products,
+       std::vector<Product> &    unfinished)
+{
+	std::map<std::string, Product> active;
+	for (const Event &event : events) {
+		Product *product;
+		if (event.event == JournalEvent::SPAWN) {
+			product             = start_product(active, products, event);
+			product->origin     = event.subject;
+			product->base_color = event.value;
+			continue;
+		}
+		auto found = active.find(event.workpiece);
+		if (found != active.end()) {
+			product = &found->second;
+		} else if (event.event == JournalEvent::RING || event.event == JournalEvent::CAP
+		           || event.event == JournalEvent::GRIP || event.event == JournalEvent::DELIVER) {
+			// the workpiece was not spawned by a station, e.g. it is part of the world
+			product = start_product(active, products, event);
+		} else {
+			// e.g. leaving the delivery zone after the product was finished
+			continue;
+		}
+		switch (event.event) {
+		case JournalEvent::RING: product->ring_colors.push_back(event.value); break;
+		case JournalEvent::CAP:
+			product->have_cap  = true;
+			product->cap_color = event.value;
+			break;
+		case JournalEvent::CAP_REMOVED: product->have_cap = false; break;
+		case JournalEvent::GRIP: product->held_since = event.sim_time; break;
+		case JournalEvent::RELEASE:
+			if (product->held_since >= 0) {
+				product->held_time += event.sim_time - product->held_since;
+				product->held_since = -1;
+			}
+			break;
+		case JournalEvent::DELIVER:
+		case JournalEvent::RECYCLE:
+			product->delivered = product->delivered || event.event == JournalEvent::DELIVER;
+			product->end_time  = event.sim_time;
+			products.push_back(*product);
+			active.erase(event.workpiece);
+			break;
+		default: break;
+		}
+	}
+	for (auto &entry : active) {
+		// the life of an unfinished product lasts until the end of the journal
+		entry.second.end_time = events.back().sim_time;
+		unfinished.push_back(entry.second);
+	}
+}
+
+static void
+print_product(const Product &product)
+{
+	std::string rings;
+	for (uint16_t color : product.ring_colors) {
+		rings += " " + color_name(color);
+	}
+	printf("%-16s %-8s %7.1f %7.1f  %s base, rings:%s, cap %s, held %.1f s%s\n",
+	       product.workpiece.c_str(),
+	       product.origin.empty() ? "-" : product.origin.c_str(),
+	       product.spawn_time,
+	       product.end_time - product.spawn_time,
+	       color_name(product.base_color).c_str(),
+	       rings.empty() ? " none" : rings.c_str(),
+	       product.have_cap ? color_name(product.cap_color).c_str() : "none",
+	       product.held_time,
+	       product.delivered ? "" : ", not delivered");
+}
+
+/** Print the lead times of the delivered products by complexity. */
+static void
+print_statistics(const std::vector<Product> &products)
+{
+	std::map<std::size_t, std::vector<const Product *>> by_complexity;
+	for (const Product &product : products) {
+		if (product.delivered) {
+			by_complexity[product.ring_colors.size()].push_back(&product);
+		}
+	}
+	printf("%-10s %6s %9s %9s %9s %9s %9s\n",
+	       "complexity",
+	       "count",
+	       "min [s]",
+	       "median",
+	       "mean",
+	       "max",
+	       "held");
+	for (auto &entry : by_complexity) {
+		std::vector<double> lead_times;
+		double              held = 0;
+		for (const Product *product : entry.second) {
+			lead_times.push_back(product->end_time - product->spawn_time);
+			held += product->held_time;
+		}
+		std::sort(lead_times.begin(), lead_times.end());
+		double sum = 0;
+		for (double lead_time : lead_times) {
+			sum += lead_time;
+		}
+		printf("C%-9zu %6zu %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+		       entry.first,
+		       lead_times.size(),
+		       lead_times.front(),
+		       lead_times[lead_times.size() / 2],
+		       sum / lead_times.size(),
+		       lead_times.back(),
+		       held / lead_times.size());
+	}
+}
+
+static void
+print_usage(const char *program_name)
+{
+	printf("Usage: %s [-h] [-v] JOURNAL\n"
+	       " -h       Show this help message\n"
+	       " -v       Print every product, not only the statistics\n"
+	       "\n"
+	       "Prints the lead times of the delivered products by complexity, from the\n"
+	       "spawn of the base until the delivery. Enable the journal with the\n"
+	       "plugins/journal/file config value.\n",
+	       program_name);
+}
+
+int
+main(int argc, char **argv)
+{
+	std::vector<Event> events;
+	uint64_t           dropped = 0;
+	bool               verbose = false;
+	try {
+		fawkes::ArgumentParser argp(argc, argv, "hv");
+		if (argp.has_arg("h")) {
+			print_usage(argp.program_name());
+			return 0;
+		}
+		if (argp.num_items() != 1) {
+			print_usage(argp.program_name());
+			return 1;
+		}
+		verbose = argp.has_arg("v");
+		read_journal(argp.items()[0], events, dropped);
+	} catch (fawkes::Exception &e) {
+		fprintf(stderr, "%s\n", e.what());
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	std::vector<Product> products;
+	std::vector<Product> unfinished;
+	replay(events, products, unfinished);
+
+	if (verbose) {
+		printf("%-16s %-8s %7s %7s\n", "workpiece", "origin", "spawn", "life");
+		for (const Product &product : products) {
+			print_product(product);
+		}
+		for (const Product &product : unfinished) {
+			print_product(product);
+		}
+		printf("\n");
+	}
+	std::size_t delivered = std::count_if(products.begin(), products.end(), [](const Product &p) {
+		return p.delivered;
+	});
+	printf("%zu events, %zu products: %zu delivered, %zu recycled, %zu unfinished\n",
+	       events.size(),
+	       products.size() + unfinished.size(),
+	       delivered,
+	       products.size() - delivered,
+	       unfinished.size());
+	if (dropped > 0) {
+		printf("%lu events were dropped, the journal was full\n", (unsigned long)dropped);
+	}
+	if (delivered > 0) {
+		printf("\n");
+		print_statistics(products);
+	}
+	return 0;
+}